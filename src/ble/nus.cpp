@@ -1,8 +1,12 @@
 #include "ble/nus.hpp"
 
+#include <zephyr/bluetooth/conn.h>
 #include <zephyr/bluetooth/gatt.h>
 #include <zephyr/logging/log.h>
 
+#include <algorithm>
+#include <climits>
+
 // can't call it bt_nus since that's already in use :/
 LOG_MODULE_REGISTER(bt_app_nus, CONFIG_NRF_TEST_BLE_LOG_LEVEL);
 
@@ -47,13 +51,33 @@ int bt::nus::init()
   return 0;
 }
 
+static void min_mtu(bt_conn *conn, void *user_data)
+{
+  auto *mtu = (uint32_t *)user_data;
+  auto conn_mtu = bt_nus_get_mtu(conn);
+  // 0 while the connection is still being set up
+  if (conn_mtu > 0)
+  {
+    *mtu = std::min(*mtu, conn_mtu);
+  }
+}
+
 int bt::nus::send(const uint8_t *data, uint16_t len)
 {
-  int err = bt_nus_send(NULL, data, len);
-  if (err)
+  // a notification can't be longer than the mtu, data goes out in as many as needed
+  uint32_t mtu = UINT32_MAX;
+  bt_conn_foreach(BT_CONN_TYPE_LE, min_mtu, &mtu);
+
+  for (uint16_t pos = 0; pos < len;)
   {
-    LOG_ERR("Error sending NUS data (err %d)", err);
-    return err;
+    auto chunk = uint16_t(std::min<uint32_t>(len - pos, mtu));
+    int err = bt_nus_send(NULL, data + pos, chunk);
+    if (err)
+    {
+      LOG_ERR("Error sending NUS data (err %d)", err);
+      return err;
+    }
+    pos += chunk;
   }
   return 0;
 }
@@ -12,6 +12,7 @@ namespace bt::nus
 
   int init();
   void discover_completed(bt_gatt_dm *dm, void *ctx);
+  // Sends data to every connected client, split into notifications that fit the smallest mtu.
   int send(const uint8_t *data, uint16_t len);
   bool can_send();
   void set_callback(nus_cb *recv_cb);
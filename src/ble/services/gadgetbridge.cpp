@@ -3,6 +3,7 @@
 #include "ble/services/gadgetbridge/st_parse.hpp"
 
 #include "ble/nus.hpp"
+#include "perf/profiler.hpp"
 
 #include <zephyr/logging/log.h>
 
@@ -34,6 +35,14 @@ void parse(std::string_view sv)
   {
     bt::services::gadgetbridge::st_parse(sv);
   }
+  else if (sv.starts_with("perf("))
+  {
+    bt::services::gadgetbridge::send_perf();
+    if (sv.starts_with("perf(reset)"))
+    {
+      perf::reset();
+    }
+  }
 }
 
 void consume(const uint8_t *data, uint16_t len)
@@ -55,7 +64,7 @@ void consume(const uint8_t *data, uint16_t len)
     }
     recv_buf.fill(0);
     recv_pos = 0;
-    if (sv.starts_with("GB(") || sv.starts_with("setTime("))
+    if (sv.starts_with("GB(") || sv.starts_with("setTime(") || sv.starts_with("perf("))
     {
       state = Consume;
     }
@@ -107,4 +116,19 @@ int bt::services::gadgetbridge::send_ver()
                                 "\"fw\":\"" GIT_HASH "\","
                                 "\"hw\":\"" CONFIG_BT_DIS_HW_REV_STR "\"}");
   return bt::nus::send(reinterpret_cast<const uint8_t *>(sv.data()), sv.length());
+}
+
+int bt::services::gadgetbridge::send_perf()
+{
+  std::array<char, 1024> buf;
+  // room for the newline
+  int len = perf::to_json(buf.data(), buf.size() - 1);
+  if (len < 0)
+  {
+    LOG_ERR("Could not format perf stats (err %d)", len);
+    return len;
+  }
+  // it spans several notifications, gadgetbridge joins them up to the end of the line
+  buf[len++] = '\n';
+  return bt::nus::send(reinterpret_cast<const uint8_t *>(buf.data()), len);
 }
\ No newline at end of file
@@ -6,4 +6,6 @@ namespace bt::services::gadgetbridge
 {
   void init();
   int send_ver();
+  // Sends the display pipeline stats, requested with perf() or perf(reset) to also clear them.
+  int send_perf();
 }
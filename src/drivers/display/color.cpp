@@ -0,0 +1,104 @@
+#include "drivers/display/color.hpp"
+
+#include <cstring>
+
+#if defined(__ARM_FEATURE_DSP)
+#include <zephyr/arch/cpu.h>
+#endif
+
+using namespace color;
+
+template <bool Swap>
+static inline uint16_t convert(uint32_t xrgb)
+{
+  return Swap ? rgb565_swapped(xrgb) : rgb565(xrgb);
+}
+
+template <bool Swap>
+static void convert_row_impl(const uint32_t *src, uint16_t *dst, size_t count)
+{
+#if defined(__ARM_FEATURE_DSP)
+  // align dst so pairs of pixels can be stored as one word
+  if (count > 0 && (uintptr_t(dst) & 0x2) != 0)
+  {
+    *dst++ = convert<Swap>(*src++);
+    count--;
+  }
+
+  auto *dst32 = (uint32_t *)dst;
+  for (; count >= 2; count -= 2)
+  {
+    uint32_t p0 = src[0];
+    uint32_t p1 = src[1];
+    src += 2;
+    // pack both pixels into one word, first pixel in the low half, and swap both halves at once
+    uint32_t packed = __PKHBT(rgb565(p0), rgb565(p1), 16);
+    if constexpr (Swap)
+    {
+      packed = __REV16(packed);
+    }
+    *dst32++ = packed;
+  }
+  dst = (uint16_t *)dst32;
+#endif
+
+  for (; count > 0; --count)
+  {
+    *dst++ = convert<Swap>(*src++);
+  }
+}
+
+template <bool Swap>
+static size_t pack_row_444_impl(const uint16_t *src, uint8_t *dst, size_t count)
+{
+  const auto *start = dst;
+
+  // two pixels per word in, three bytes out, the stores stay behind the loads when packing in place
+  for (; count >= 2; count -= 2)
+  {
+    uint32_t pair;
+    memcpy(&pair, src, sizeof(pair));
+    src += 2;
+    if constexpr (Swap)
+    {
+      pair = (pair & 0x00FF00FF) << 8 | (pair >> 8 & 0x00FF00FF);
+    }
+    // first pixel in the low half on little endian, it goes out first
+    uint32_t packed = uint32_t(rgb444(uint16_t(pair))) << 12 | rgb444(uint16_t(pair >> 16));
+    dst[0] = uint8_t(packed >> 16);
+    dst[1] = uint8_t(packed >> 8);
+    dst[2] = uint8_t(packed);
+    dst += 3;
+  }
+
+  // an odd pixel is padded with a nibble the panel ignores
+  if (count > 0)
+  {
+    uint16_t c = Swap ? uint16_t(*src << 8 | *src >> 8) : *src;
+    uint16_t packed = rgb444(c);
+    dst[0] = uint8_t(packed >> 4);
+    dst[1] = uint8_t(packed << 4);
+    dst += 2;
+  }
+  return size_t(dst - start);
+}
+
+void color::convert_row(const uint32_t *src, uint16_t *dst, size_t count)
+{
+  convert_row_impl<false>(src, dst, count);
+}
+
+void color::convert_row_swapped(const uint32_t *src, uint16_t *dst, size_t count)
+{
+  convert_row_impl<true>(src, dst, count);
+}
+
+size_t color::pack_row_444(const uint16_t *src, uint8_t *dst, size_t count)
+{
+  return pack_row_444_impl<false>(src, dst, count);
+}
+
+size_t color::pack_row_444_swapped(const uint16_t *src, uint8_t *dst, size_t count)
+{
+  return pack_row_444_impl<true>(src, dst, count);
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// RGB888 to RGB565 conversion. Channels are truncated to their top bits like lv_color_make does, so
+// converted colors match the ones lvgl renders itself.
+namespace color
+{
+  constexpr uint16_t rgb565(uint8_t r, uint8_t g, uint8_t b)
+  {
+    return uint16_t((r & 0xF8) << 8 | (g & 0xFC) << 3 | b >> 3);
+  }
+
+  // 0x00RRGGBB, the layout of lv_color32_t and most image decoders
+  constexpr uint16_t rgb565(uint32_t xrgb)
+  {
+    return uint16_t((xrgb >> 8 & 0xF800) | (xrgb >> 5 & 0x07E0) | (xrgb >> 3 & 0x001F));
+  }
+
+  // High byte first, the order the panel expects and lvgl uses with LV_COLOR_16_SWAP.
+  constexpr uint16_t rgb565_swapped(uint32_t xrgb)
+  {
+    auto c = rgb565(xrgb);
+    return uint16_t(c << 8 | c >> 8);
+  }
+
+  static_assert(rgb565(0xFF, 0xFF, 0xFF) == 0xFFFF);
+  static_assert(rgb565(0x0F82FAu) == rgb565(0x0F, 0x82, 0xFA));
+  static_assert(rgb565_swapped(0xFF0000u) == 0x00F8);
+
+  // RGB565 to the 12-bit RGB444 the panel takes with COLMOD 0x03, truncated like above.
+  constexpr uint16_t rgb444(uint16_t c)
+  {
+    return uint16_t((c >> 4 & 0xF00) | (c >> 3 & 0x0F0) | (c >> 1 & 0x00F));
+  }
+
+  // Bytes taken by count packed RGB444 pixels, two pixels share three bytes and an odd last pixel
+  // takes two.
+  constexpr size_t rgb444_size(size_t count)
+  {
+    return (count * 3 + 1) / 2;
+  }
+
+  static_assert(rgb444(0xFFFF) == 0xFFF);
+  static_assert(rgb444(rgb565(0x0F82FAu)) == 0x08F);
+  static_assert(rgb444_size(3) == 5);
+
+  // Converts a row of 0x00RRGGBB pixels. On Cortex-M with the DSP extension two pixels are packed
+  // and stored per word.
+  void convert_row(const uint32_t *src, uint16_t *dst, size_t count);
+  // Same as convert_row with every pixel byte swapped for the panel.
+  void convert_row_swapped(const uint32_t *src, uint16_t *dst, size_t count);
+
+  // Packs a row of RGB565 pixels into RGB444 in wire order, two pixels per three bytes, and returns
+  // the bytes written. dst may point to src, the packed pixels never overtake the ones still to be
+  // read, so lvgl's draw buffer can be packed in place right before it is sent.
+  size_t pack_row_444(const uint16_t *src, uint8_t *dst, size_t count);
+  // Same as pack_row_444 for byte swapped pixels, lvgl's output with LV_COLOR_16_SWAP.
+  size_t pack_row_444_swapped(const uint16_t *src, uint8_t *dst, size_t count);
+}
@@ -9,13 +9,17 @@
 #include <zephyr/drivers/spi.h>
 #include <zephyr/sys/byteorder.h>
 #include <zephyr/kernel.h>
-#include <math.h>
 #include <zephyr/logging/log.h>
 #include <inttypes.h>
 #include <zephyr/pm/pm.h>
 #include <zephyr/pm/device.h>
+#include <zephyr/pm/device_runtime.h>
 #include <zephyr/pm/policy.h>
 
+#include "drivers/display/color.hpp"
+#include "drivers/display/gc9a01.hpp"
+
+#include <algorithm>
 #include <array>
 
 LOG_MODULE_REGISTER(gc9a01, CONFIG_DISPLAY_LOG_LEVEL);
@@ -39,6 +43,8 @@ enum DisplayCommand
   GC9A01A_TEON = 0x35,      ///< Tearing effect line on
   GC9A01A_MADCTL = 0x36,    ///< Memory Access Control
   GC9A01A_VSCRSADD = 0x37,  ///< Vertical Scrolling Start Address
+  GC9A01A_IDMOFF = 0x38,    ///< Idle Mode OFF
+  GC9A01A_IDMON = 0x39,     ///< Idle Mode ON, eight colors
   GC9A01A_PIXFMT = 0x3A,    ///< COLMOD: Pixel Format Set
   GC9A01A1_DFUNCTR = 0xB6,  ///< Display Function Control
   GC9A01A1_VREG1A = 0xC3,   ///< Vreg1a voltage control
@@ -100,6 +106,35 @@ enum MemoryAccessParams
 constexpr auto DISPLAY_WIDTH = DT_INST_PROP(0, width);
 constexpr auto DISPLAY_HEIGHT = DT_INST_PROP(0, height);
 
+#if DT_PROP(DT_INST(0, buydisplay_gc9a01), rotation) == 0
+constexpr uint8_t MADCTL_INIT = ExchangeModeReverse | RowOrderBottomToTop | ColumnOrderRightToLeft | PixelOrderBGR;
+#elif DT_PROP(DT_INST(0, buydisplay_gc9a01), rotation) == 90
+constexpr uint8_t MADCTL_INIT = HorizonalRefreshLeftToRight | RowOrderBottomToTop | 0 | PixelOrderBGR;
+#elif DT_PROP(DT_INST(0, buydisplay_gc9a01), rotation) == 180
+constexpr uint8_t MADCTL_INIT = ExchangeModeReverse | 0 | 0 | PixelOrderBGR;
+#elif DT_PROP(DT_INST(0, buydisplay_gc9a01), rotation) == 270
+constexpr uint8_t MADCTL_INIT = HorizonalRefreshLeftToRight | ColumnOrderRightToLeft | 0 | 0 | PixelOrderBGR;
+#else
+#error "Unsupported rotation. Use 0, 90, 180 or 270."
+#endif
+
+// the scroll registers count gate lines, the panel has as many as it has rows
+constexpr uint16_t SCROLL_LINES = DISPLAY_HEIGHT;
+
+constexpr uint8_t FRAMERATE_NORMAL = 0x34;
+
+// power up and sleep timing from the datasheet, 150 ms after a reset as before
+constexpr int64_t RESET_PULSE_MS = 5;
+constexpr int64_t RESET_SETTLE_MS = 150;
+constexpr int64_t SLEEP_CMD_DELAY_MS = 5;      // after SLPIN or SLPOUT before the next command
+constexpr int64_t SLEEP_TOGGLE_DELAY_MS = 120; // between SLPIN and SLPOUT either way
+
+// solid fills send one small buffer over and over, chained into a single spi transfer
+constexpr size_t FILL_PIXELS = DISPLAY_WIDTH * 4;
+// in 12-bit mode the buffer holds whole three byte pairs so the pattern lines up across it
+static_assert(FILL_PIXELS * sizeof(uint16_t) % 3 == 0);
+constexpr size_t FILL_CHAIN = 16;
+
 struct GC9A01CMD
 {
   uint8_t cmd;
@@ -125,17 +160,7 @@ constexpr GC9A01CMD gc9a01_initcmds[] = {
     {0x8E, 1, (uint8_t[]){0xFF}},
     {0x8F, 1, (uint8_t[]){0xFF}},
     {0xB6, 2, (uint8_t[]){0x00, 0x00}},
-#if DT_PROP(DT_INST(0, buydisplay_gc9a01), rotation) == 0
-    {GC9A01A_MADCTL, 1, (uint8_t[]){ExchangeModeReverse | RowOrderBottomToTop | ColumnOrderRightToLeft | PixelOrderBGR}},
-#elif DT_PROP(DT_INST(0, buydisplay_gc9a01), rotation) == 90
-    {GC9A01A_MADCTL, 1, (uint8_t[]){HorizonalRefreshLeftToRight | RowOrderBottomToTop | 0 | PixelOrderBGR}},
-#elif DT_PROP(DT_INST(0, buydisplay_gc9a01), rotation) == 180
-    {GC9A01A_MADCTL, 1, (uint8_t[]){ExchangeModeReverse | 0 | 0 | PixelOrderBGR}},
-#elif DT_PROP(DT_INST(0, buydisplay_gc9a01), rotation) == 270
-    {GC9A01A_MADCTL, 1, (uint8_t[]){HorizonalRefreshLeftToRight | ColumnOrderRightToLeft | 0 | 0 | PixelOrderBGR}},
-#else
-#error "Unsupported rotation. Use 0, 90, 180 or 270."
-#endif
+    {GC9A01A_MADCTL, 1, (uint8_t[]){MADCTL_INIT}},
     {GC9A01A_PIXFMT, 1, (uint8_t[]){COLOR_MODE_16_BIT}},
     {0x90, 4, (uint8_t[]){0x08, 0x08, 0x08, 0x08}},
     {0xBD, 1, (uint8_t[]){0x06}},
@@ -155,7 +180,7 @@ constexpr GC9A01CMD gc9a01_initcmds[] = {
     {0xAE, 1, (uint8_t[]){0x77}},
     {0xCD, 1, (uint8_t[]){0x63}},
     {0x70, 9, (uint8_t[]){0x07, 0x07, 0x04, 0x0E, 0x0F, 0x09, 0x07, 0x08, 0x03}},
-    {GC9A01A_FRAMERATE, 1, (uint8_t[]){0x34}},
+    {GC9A01A_FRAMERATE, 1, (uint8_t[]){FRAMERATE_NORMAL}},
     {0x62, 12, (uint8_t[]){0x18, 0x0D, 0x71, 0xED, 0x70, 0x70, 0x18, 0x0F, 0x71, 0xEF, 0x70, 0x70}},
     {0x63, 12, (uint8_t[]){0x18, 0x11, 0x71, 0xF1, 0x70, 0x70, 0x18, 0x13, 0x71, 0xF3, 0x70, 0x70}},
     {0x64, 7, (uint8_t[]){0x28, 0x29, 0xF1, 0x01, 0xF1, 0x00, 0x07}},
@@ -175,15 +200,76 @@ struct gc9a01_config_t
   struct gpio_dt_spec dc_gpio;
   struct gpio_dt_spec bl_gpio;
   struct gpio_dt_spec reset_gpio;
+  struct gpio_dt_spec te_gpio;
 };
 
-uint16_t rgb8_to_rgb565(uint8_t r, uint8_t g, uint8_t b)
+struct gc9a01_window_t
 {
-  uint16_t red5 = uint16_t(float(r) / 255.0f * 31.0f);
-  uint16_t gre5 = uint16_t(float(g) / 255.0f * 63.0f);
-  uint16_t blu5 = uint16_t(float(b) / 255.0f * 31.0f);
-  return ((red5 << 11) | (gre5 << 5) | blu5);
-}
+  uint16_t x, y, endx, endy;
+  bool valid;
+};
+
+// Vertical scrolling in panel terms: gate lines [top, top + len) show GRAM rows shifted by offset,
+// the lines outside of it are fixed. Callers work in display coordinates along the scroll axis.
+struct gc9a01_scroll_t
+{
+  uint16_t start, len; // scroll area in display coordinates
+  uint16_t top;        // first gate line of the scroll area
+  uint16_t offset;     // gate lines the GRAM rows are shifted by, what VSCRSADD holds minus top
+  uint16_t pending;    // offset for the next write
+  bool dirty;          // pending has not been sent yet
+};
+
+struct gc9a01_data_t
+{
+  const device *dev;
+  // held by whoever currently owns the SPI bus and the DC line, including an in flight async transfer
+  k_sem bus_idle;
+
+  // the bus stays resumed while there are references and for an idle timeout after the last one is
+  // dropped, so the bands of a frame and back to back frames don't pay for a resume each
+  atomic_t bus_refs;
+  bool bus_active;
+  bool bus_runtime;
+  k_mutex bus_pm_lock;
+  k_work_delayable bus_idle_work;
+  gc9a01_bus_stats_t bus_stats;
+
+  // tearing effect line, the first flush of a refresh waits for its edge
+  gpio_callback te_gpio_cb;
+  k_sem te_sem;
+  k_spinlock te_lock;
+  bool te_sync;
+  gc9a01_te_cb_t te_cb;
+  void *te_user_data;
+  // every transfer goes through this copy so SPI_HOLD_ON_CS can be toggled without reconfiguring the bus
+  spi_config bus_config;
+  // last CASET/PASET sent to the panel so unchanged window registers aren't written again
+  gc9a01_window_t window;
+  uint8_t madctl;
+  gc9a01_scroll_t scroll;
+  gc9a01_color_depth_t depth;
+
+  // the reset and init sequence steps through delayable work instead of sleeping, bus_idle is held
+  // from its start until the panel takes commands
+  k_work_delayable init_work;
+  uint8_t init_step;
+  // uptime of the last SLPIN or SLPOUT, the panel ignores commands for a few ms after them
+  int64_t sleep_changed_at;
+
+  // pixels of the last fill color in wire order, only rewritten when the color or depth changes
+  std::array<uint16_t, FILL_PIXELS> fill_buf;
+  std::array<spi_buf, FILL_CHAIN> fill_chain;
+  uint16_t fill_color;
+  bool fill_valid;
+
+#ifdef CONFIG_DISPLAY_GC9A01_ASYNC
+  spi_buf xfer_buf;
+  spi_buf_set xfer_buf_set;
+  gc9a01_write_cb_t write_cb;
+  void *write_user_data;
+#endif
+};
 
 int gc9a01_write_cmd(const device *dev, uint8_t cmd);
 int gc9a01_write_data(const device *dev, const uint8_t *data, size_t len);
@@ -192,50 +278,274 @@ void gc9a01_set_frame(const device *dev,
                       const uint16_t x, const uint16_t y,
                       const uint16_t endx, const uint16_t endy);
 
-// these are macros so the __ASSERT macro picks up the correct line of code
-#define gc9a01_spi_resume(dev)                                                \
-  {                                                                           \
-    const auto *config = (gc9a01_config_t *)dev->config;                      \
-    auto rc = pm_device_action_run(config->bus.bus, PM_DEVICE_ACTION_RESUME); \
-    __ASSERT(rc == -EALREADY || rc == 0, "Failed resume SPI Bus");            \
+// Packs a command sequence into one buffer. Bytes with the same DC level are merged into one run and
+// all runs are sent back to back with chip select held. The SPIM DCX pin isn't exposed by the zephyr
+// spi driver, so DC is switched between the precomputed runs instead.
+struct gc9a01_batch_t
+{
+  static constexpr size_t MaxBytes = 16;
+  static constexpr size_t MaxRuns = 8;
+
+  std::array<uint8_t, MaxBytes> bytes;
+  std::array<spi_buf, MaxRuns> runs;
+  std::array<uint8_t, MaxRuns> dc;
+  size_t len{0};
+  size_t count{0};
+
+  void push(uint8_t level, const uint8_t *src, size_t n)
+  {
+    __ASSERT(len + n <= MaxBytes, "GC9A01 batch overflow");
+    std::copy(src, src + n, &bytes[len]);
+    if (count > 0 && dc[count - 1] == level)
+    {
+      runs[count - 1].len += n;
+    }
+    else
+    {
+      __ASSERT(count < MaxRuns, "GC9A01 batch overflow");
+      runs[count] = {.buf = &bytes[len], .len = n};
+      dc[count] = level;
+      ++count;
+    }
+    len += n;
   }
 
-#define gc9a01_spi_suspend(dev)                                                \
-  {                                                                            \
-    const auto *config = (gc9a01_config_t *)dev->config;                       \
-    auto rc = pm_device_action_run(config->bus.bus, PM_DEVICE_ACTION_SUSPEND); \
-    __ASSERT(rc == -EALREADY || rc == 0, "Failed suspend SPI Bus");            \
+  void cmd(uint8_t c, const uint8_t *args = nullptr, size_t argc = 0)
+  {
+    push(0, &c, 1);
+    if (args != nullptr && argc > 0)
+    {
+      push(1, args, argc);
+    }
   }
+};
 
-void gc9a01_clear(const device *dev, uint16_t color)
+// A bus without pm, like the SPI emulator, reports -ENOSYS or -ENOTSUP and is always powered.
+[[maybe_unused]] static bool gc9a01_bus_pm_ok(int rc)
 {
-  gc9a01_set_frame(dev, 0, 0, DISPLAY_WIDTH - 1, DISPLAY_HEIGHT - 1);
+  return rc == 0 || rc == -EALREADY || rc == -ENOSYS || rc == -ENOTSUP;
+}
 
-  std::array<uint16_t, 100> rgb;
-  rgb.fill(__bswap_16(color)); // spi writes this in the wrong endian-ness so we have to flip the byte order
-  gc9a01_write_cmd(dev, GC9A01A_RAMWR);
-  for (auto i = 0u; i < (DISPLAY_WIDTH * DISPLAY_HEIGHT) / rgb.size(); ++i)
+// Takes a reference on the SPI bus power, resuming it if it was suspended.
+// Only call from thread context.
+void gc9a01_bus_get(const device *dev)
+{
+  const auto *config = (gc9a01_config_t *)dev->config;
+  auto *data = (gc9a01_data_t *)dev->data;
+
+  k_mutex_lock(&data->bus_pm_lock, K_FOREVER);
+  atomic_inc(&data->bus_refs);
+  data->bus_stats.gets++;
+  if (!data->bus_active)
   {
-    gc9a01_write_data(dev, (uint8_t *)rgb.data(), rgb.size() * 2);
+    auto rc = data->bus_runtime ? pm_device_runtime_get(config->bus.bus)
+                                : pm_device_action_run(config->bus.bus, PM_DEVICE_ACTION_RESUME);
+    __ASSERT(gc9a01_bus_pm_ok(rc), "Failed resume SPI Bus");
+    data->bus_active = true;
+    data->bus_stats.resumes++;
   }
-  for (auto i = 0u; i < (DISPLAY_WIDTH * DISPLAY_HEIGHT) % rgb.size(); ++i)
+  k_mutex_unlock(&data->bus_pm_lock);
+}
+
+// Drops a reference on the SPI bus power, the bus is suspended once it has been idle for
+// CONFIG_DISPLAY_GC9A01_BUS_IDLE_TIMEOUT_MS. Safe to call from an interrupt.
+void gc9a01_bus_put(const device *dev)
+{
+  auto *data = (gc9a01_data_t *)dev->data;
+
+  if (atomic_dec(&data->bus_refs) == 1)
   {
-    gc9a01_write_data(dev, (uint8_t *)rgb.data(), ((DISPLAY_WIDTH * DISPLAY_HEIGHT) % rgb.size()) * 2);
+    k_work_reschedule(&data->bus_idle_work, K_MSEC(CONFIG_DISPLAY_GC9A01_BUS_IDLE_TIMEOUT_MS));
   }
 }
 
-void gc9a01_clear(const device *dev, uint8_t r, uint8_t g, uint8_t b)
+void gc9a01_bus_idle_work_handler(k_work *work)
+{
+  auto *data = CONTAINER_OF(k_work_delayable_from_work(work), gc9a01_data_t, bus_idle_work);
+  const auto *config = (gc9a01_config_t *)data->dev->config;
+
+  k_mutex_lock(&data->bus_pm_lock, K_FOREVER);
+  if (atomic_get(&data->bus_refs) == 0 && data->bus_active)
+  {
+    auto rc = data->bus_runtime ? pm_device_runtime_put(config->bus.bus)
+                                : pm_device_action_run(config->bus.bus, PM_DEVICE_ACTION_SUSPEND);
+    __ASSERT(gc9a01_bus_pm_ok(rc), "Failed suspend SPI Bus");
+    data->bus_active = false;
+    data->bus_stats.suspends++;
+  }
+  k_mutex_unlock(&data->bus_pm_lock);
+}
+
+static int32_t gc9a01_remaining_ms(int64_t until)
+{
+  return int32_t(std::max<int64_t>(until - k_uptime_get(), 0));
+}
+
+int32_t gc9a01_cmd_ready_in(const device *dev)
+{
+  auto *data = (gc9a01_data_t *)dev->data;
+  return gc9a01_remaining_ms(data->sleep_changed_at + SLEEP_CMD_DELAY_MS);
+}
+
+int32_t gc9a01_sleep_toggle_in(const device *dev)
+{
+  auto *data = (gc9a01_data_t *)dev->data;
+  return gc9a01_remaining_ms(data->sleep_changed_at + SLEEP_TOGGLE_DELAY_MS);
+}
+
+// Takes ownership of the DC line and the bus, waiting for any in flight async transfer. Right after
+// SLPOUT a caller that didn't check gc9a01_cmd_ready_in waits here for the panel to take commands.
+void gc9a01_bus_acquire(const device *dev)
+{
+  auto *data = (gc9a01_data_t *)dev->data;
+  k_sem_take(&data->bus_idle, K_FOREVER);
+  if (auto wait = gc9a01_cmd_ready_in(dev); wait > 0)
+  {
+    k_msleep(wait);
+  }
+  gc9a01_bus_get(dev);
+}
+
+// Safe to call from an interrupt.
+void gc9a01_bus_release(const device *dev)
+{
+  auto *data = (gc9a01_data_t *)dev->data;
+  gc9a01_bus_put(dev);
+  k_sem_give(&data->bus_idle);
+}
+
+static inline bool gc9a01_has_te(const device *dev)
+{
+  const auto *config = (gc9a01_config_t *)dev->config;
+  return config->te_gpio.port != nullptr;
+}
+
+static void gc9a01_te_arm(const device *dev)
+{
+  const auto *config = (gc9a01_config_t *)dev->config;
+  gpio_pin_interrupt_configure_dt(&config->te_gpio, GPIO_INT_EDGE_TO_ACTIVE);
+}
+
+static void gc9a01_te_isr_handler(const device *port, gpio_callback *cb, uint32_t pins)
+{
+  auto *data = CONTAINER_OF(cb, gc9a01_data_t, te_gpio_cb);
+  const auto *config = (gc9a01_config_t *)data->dev->config;
+
+  k_spinlock_key_t key = k_spin_lock(&data->te_lock);
+  auto te_cb = data->te_cb;
+  auto *te_user_data = data->te_user_data;
+  data->te_cb = nullptr;
+  // the line toggles at the panel refresh rate, only keep the interrupt while someone is waiting on it
+  if (!data->te_sync)
+  {
+    gpio_pin_interrupt_configure_dt(&config->te_gpio, GPIO_INT_DISABLE);
+  }
+  k_spin_unlock(&data->te_lock, key);
+
+  k_sem_give(&data->te_sem);
+  if (te_cb != nullptr)
+  {
+    te_cb(data->dev, te_user_data);
+  }
+}
+
+// Holds back the first flush of a refresh until the panel starts a new scan.
+static void gc9a01_te_wait(const device *dev)
+{
+  auto *data = (gc9a01_data_t *)dev->data;
+
+  k_spinlock_key_t key = k_spin_lock(&data->te_lock);
+  bool sync = data->te_sync;
+  data->te_sync = false;
+  k_spin_unlock(&data->te_lock, key);
+
+  if (!sync)
+  {
+    return;
+  }
+  k_sem_reset(&data->te_sem);
+  gc9a01_te_arm(dev);
+  if (k_sem_take(&data->te_sem, K_MSEC(CONFIG_DISPLAY_GC9A01_TE_TIMEOUT_MS)) != 0)
+  {
+    LOG_WRN("Timed out waiting for TE");
+  }
+}
+
+int gc9a01_on_next_te(const device *dev, gc9a01_te_cb_t cb, void *user_data)
+{
+  auto *data = (gc9a01_data_t *)dev->data;
+
+  if (!gc9a01_has_te(dev))
+  {
+    return -ENOTSUP;
+  }
+
+  k_spinlock_key_t key = k_spin_lock(&data->te_lock);
+  data->te_cb = cb;
+  data->te_user_data = user_data;
+  k_spin_unlock(&data->te_lock, key);
+
+  if (cb != nullptr)
+  {
+    gc9a01_te_arm(dev);
+  }
+  return 0;
+}
+
+void gc9a01_frame_begin(const device *dev)
+{
+  auto *data = (gc9a01_data_t *)dev->data;
+
+  gc9a01_bus_get(dev);
+  if (gc9a01_has_te(dev))
+  {
+    k_spinlock_key_t key = k_spin_lock(&data->te_lock);
+    data->te_sync = true;
+    k_spin_unlock(&data->te_lock, key);
+  }
+}
+
+void gc9a01_frame_end(const device *dev)
+{
+  auto *data = (gc9a01_data_t *)dev->data;
+
+  // a refresh without flushes never consumed the sync
+  k_spinlock_key_t key = k_spin_lock(&data->te_lock);
+  data->te_sync = false;
+  k_spin_unlock(&data->te_lock, key);
+
+  gc9a01_bus_put(dev);
+}
+
+void gc9a01_get_bus_stats(const device *dev, gc9a01_bus_stats_t *stats)
 {
-  gc9a01_clear(dev, rgb8_to_rgb565(r, g, b));
+  auto *data = (gc9a01_data_t *)dev->data;
+  k_mutex_lock(&data->bus_pm_lock, K_FOREVER);
+  *stats = data->bus_stats;
+  k_mutex_unlock(&data->bus_pm_lock);
+}
+
+static inline void gc9a01_set_cs_hold(const device *dev, bool hold)
+{
+  auto *dev_data = (gc9a01_data_t *)dev->data;
+  if (hold)
+  {
+    dev_data->bus_config.operation |= SPI_HOLD_ON_CS;
+  }
+  else
+  {
+    dev_data->bus_config.operation &= ~SPI_HOLD_ON_CS;
+  }
 }
 
 int gc9a01_write_cmd(const device *dev, uint8_t cmd)
 {
   const auto *config = (gc9a01_config_t *)dev->config;
+  auto *dev_data = (gc9a01_data_t *)dev->data;
   struct spi_buf buf = {.buf = &cmd, .len = sizeof(cmd)};
   struct spi_buf_set buf_set = {.buffers = &buf, .count = 1};
   gpio_pin_set_dt(&config->dc_gpio, 0);
-  if (spi_write_dt(&config->bus, &buf_set) != 0)
+  if (spi_write(config->bus.bus, &dev_data->bus_config, &buf_set) != 0)
   {
     LOG_ERR("Failed sending command");
     return -EIO;
@@ -246,10 +556,11 @@ int gc9a01_write_cmd(const device *dev, uint8_t cmd)
 int gc9a01_write_data(const device *dev, const uint8_t *data, size_t len)
 {
   const auto *config = (gc9a01_config_t *)dev->config;
+  auto *dev_data = (gc9a01_data_t *)dev->data;
   struct spi_buf buf = {.buf = (void *)data, .len = len};
   struct spi_buf_set buf_set = {.buffers = &buf, .count = 1};
   gpio_pin_set_dt(&config->dc_gpio, 1);
-  if (spi_write_dt(&config->bus, &buf_set) != 0)
+  if (spi_write(config->bus.bus, &dev_data->bus_config, &buf_set) != 0)
   {
     LOG_ERR("Failed sending data");
     return -EIO;
@@ -271,51 +582,421 @@ inline int gc9a01_write_cmd_data(const device *dev, uint8_t cmd, const uint8_t *
   return 0;
 }
 
+// Sends every run of the batch, chip select stays asserted afterwards if hold is set so the caller can
+// follow up with the pixel data in the same chip select window.
+int gc9a01_batch_send(const device *dev, const gc9a01_batch_t &batch, bool hold)
+{
+  const auto *config = (gc9a01_config_t *)dev->config;
+  auto *dev_data = (gc9a01_data_t *)dev->data;
+
+  for (auto i = 0u; i < batch.count; ++i)
+  {
+    struct spi_buf_set buf_set = {.buffers = &batch.runs[i], .count = 1};
+    gpio_pin_set_dt(&config->dc_gpio, batch.dc[i]);
+    gc9a01_set_cs_hold(dev, hold || i + 1 < batch.count);
+    if (spi_write(config->bus.bus, &dev_data->bus_config, &buf_set) != 0)
+    {
+      LOG_ERR("Failed sending command batch");
+      gc9a01_set_cs_hold(dev, false);
+      spi_release(config->bus.bus, &dev_data->bus_config);
+      dev_data->window.valid = false;
+      return -EIO;
+    }
+  }
+  gc9a01_set_cs_hold(dev, false);
+  return 0;
+}
+
+// Adds CASET/PASET for the window to the batch, skipping the ones the panel already holds.
+void gc9a01_encode_window(const device *dev, gc9a01_batch_t &batch,
+                          const uint16_t x, const uint16_t y, const uint16_t endx, const uint16_t endy)
+{
+  auto *dev_data = (gc9a01_data_t *)dev->data;
+  auto &window = dev_data->window;
+
+  if (!window.valid || window.x != x || window.endx != endx)
+  {
+    const uint8_t args[4] = {uint8_t(x >> 8), uint8_t(x), uint8_t(endx >> 8), uint8_t(endx)};
+    batch.cmd(COL_ADDR_SET, args, sizeof(args));
+  }
+  if (!window.valid || window.y != y || window.endy != endy)
+  {
+    const uint8_t args[4] = {uint8_t(y >> 8), uint8_t(y), uint8_t(endy >> 8), uint8_t(endy)};
+    batch.cmd(ROW_ADDR_SET, args, sizeof(args));
+  }
+  window = {.x = x, .y = y, .endx = endx, .endy = endy, .valid = true};
+}
+
+// MV swaps the axes so the gate lines run along x, MY reverses the row order against them.
+static inline bool gc9a01_scroll_on_x(const gc9a01_data_t *data)
+{
+  return (data->madctl & ExchangeModeReverse) != 0;
+}
+
+// Gate line of a display coordinate along the scroll axis, the mapping is its own inverse.
+static inline uint16_t gc9a01_scroll_gate(const gc9a01_data_t *data, uint16_t c)
+{
+  return (data->madctl & RowOrderBottomToTop) ? uint16_t(SCROLL_LINES - 1 - c) : c;
+}
+
+// Moves [c1, c2] along the scroll axis to where those lines are in GRAM with the pending offset.
+// The range has to lie on one side of the wrap of the scroll area or completely outside of it.
+static int gc9a01_scroll_map(const device *dev, uint16_t &c1, uint16_t &c2)
+{
+  auto *data = (gc9a01_data_t *)dev->data;
+  const auto &scroll = data->scroll;
+
+  if (scroll.len == 0 || scroll.pending == 0)
+  {
+    return 0;
+  }
+
+  auto g1 = gc9a01_scroll_gate(data, c1);
+  auto g2 = gc9a01_scroll_gate(data, c2);
+  auto lo = std::min(g1, g2);
+  auto hi = std::max(g1, g2);
+  if (hi < scroll.top || lo >= scroll.top + scroll.len)
+  {
+    return 0;
+  }
+  if (lo < scroll.top || hi >= scroll.top + scroll.len)
+  {
+    return -EINVAL;
+  }
+
+  auto row = uint16_t(scroll.top + (lo - scroll.top + scroll.pending) % scroll.len);
+  if (row + (hi - lo) >= scroll.top + scroll.len)
+  {
+    return -EINVAL;
+  }
+  g1 = gc9a01_scroll_gate(data, row);
+  g2 = gc9a01_scroll_gate(data, uint16_t(row + hi - lo));
+  c1 = std::min(g1, g2);
+  c2 = std::max(g1, g2);
+  return 0;
+}
+
+// Adds VSCRSADD to the batch when the offset changed since the last write.
+static void gc9a01_encode_scroll(const device *dev, gc9a01_batch_t &batch)
+{
+  auto *data = (gc9a01_data_t *)dev->data;
+  const auto &scroll = data->scroll;
+
+  if (scroll.len == 0 || scroll.pending == scroll.offset)
+  {
+    return;
+  }
+  uint16_t vsp = scroll.top + scroll.pending;
+  const uint8_t args[2] = {uint8_t(vsp >> 8), uint8_t(vsp)};
+  batch.cmd(GC9A01A_VSCRSADD, args, sizeof(args));
+}
+
+// Sends the scroll area with no offset, the caller has to own the bus.
+static int gc9a01_scroll_send_define(const device *dev)
+{
+  auto *data = (gc9a01_data_t *)dev->data;
+  auto &scroll = data->scroll;
+
+  // the area in gate lines, mirrored when the row order runs against them
+  scroll.top = (data->madctl & RowOrderBottomToTop) ? uint16_t(SCROLL_LINES - scroll.start - scroll.len)
+                                                    : scroll.start;
+  uint16_t bottom = SCROLL_LINES - scroll.top - scroll.len;
+  const uint8_t def[6] = {uint8_t(scroll.top >> 8), uint8_t(scroll.top),
+                          uint8_t(scroll.len >> 8), uint8_t(scroll.len),
+                          uint8_t(bottom >> 8), uint8_t(bottom)};
+  const uint8_t vsp[2] = {uint8_t(scroll.top >> 8), uint8_t(scroll.top)};
+
+  gc9a01_batch_t batch;
+  batch.cmd(GC9A01A_VSCRDEF, def, sizeof(def));
+  batch.cmd(GC9A01A_VSCRSADD, vsp, sizeof(vsp));
+  int err = gc9a01_batch_send(dev, batch, false);
+  scroll.offset = scroll.pending = 0;
+  return err;
+}
+
+gc9a01_scroll_axis_t gc9a01_scroll_axis(const device *dev)
+{
+  auto *data = (gc9a01_data_t *)dev->data;
+  return gc9a01_scroll_on_x(data) ? GC9A01_SCROLL_X : GC9A01_SCROLL_Y;
+}
+
+int gc9a01_scroll_define(const device *dev, uint16_t start, uint16_t len)
+{
+  auto *data = (gc9a01_data_t *)dev->data;
+
+  if (len == 0 || start + len > SCROLL_LINES)
+  {
+    return -EINVAL;
+  }
+
+  gc9a01_bus_acquire(dev);
+  data->scroll.start = start;
+  data->scroll.len = len;
+  int err = gc9a01_scroll_send_define(dev);
+  gc9a01_bus_release(dev);
+  return err;
+}
+
+int gc9a01_scroll_to(const device *dev, uint16_t offset)
+{
+  auto *data = (gc9a01_data_t *)dev->data;
+  auto &scroll = data->scroll;
+
+  if (scroll.len == 0)
+  {
+    return -EINVAL;
+  }
+  offset %= scroll.len;
+  // moving content towards lower display coordinates moves it towards higher gate lines if reversed
+  scroll.pending = (data->madctl & RowOrderBottomToTop) ? uint16_t((scroll.len - offset) % scroll.len) : offset;
+  return 0;
+}
+
+uint16_t gc9a01_scroll_wrap(const device *dev)
+{
+  auto *data = (gc9a01_data_t *)dev->data;
+  const auto &scroll = data->scroll;
+
+  if (scroll.len == 0)
+  {
+    return 0;
+  }
+  // gate line that shows the first row of the area
+  uint16_t gate = scroll.top + (scroll.len - scroll.pending) % scroll.len;
+  return (data->madctl & RowOrderBottomToTop) ? uint16_t(SCROLL_LINES - gate) : gate;
+}
+
+int gc9a01_ambient_on(const device *dev, uint16_t start, uint16_t end)
+{
+  auto *data = (gc9a01_data_t *)dev->data;
+
+  if (start > end || end >= SCROLL_LINES)
+  {
+    return -EINVAL;
+  }
+
+  // the partial area counts gate lines like the scroll area
+  auto first = std::min(gc9a01_scroll_gate(data, start), gc9a01_scroll_gate(data, end));
+  auto last = std::max(gc9a01_scroll_gate(data, start), gc9a01_scroll_gate(data, end));
+  const uint8_t area[4] = {uint8_t(first >> 8), uint8_t(first), uint8_t(last >> 8), uint8_t(last)};
+  const uint8_t framerate = CONFIG_DISPLAY_GC9A01_AMBIENT_FRAMERATE;
+
+  gc9a01_batch_t batch;
+  batch.cmd(GC9A01A_PTLAR, area, sizeof(area));
+  batch.cmd(GC9A01A_PTLON);
+  batch.cmd(GC9A01A_IDMON);
+  batch.cmd(GC9A01A_FRAMERATE, &framerate, 1);
+
+  gc9a01_bus_acquire(dev);
+  int err = gc9a01_batch_send(dev, batch, false);
+  gc9a01_bus_release(dev);
+  return err;
+}
+
+int gc9a01_ambient_off(const device *dev)
+{
+  const uint8_t framerate = FRAMERATE_NORMAL;
+
+  gc9a01_batch_t batch;
+  batch.cmd(GC9A01A_FRAMERATE, &framerate, 1);
+  batch.cmd(GC9A01A_IDMOFF);
+  batch.cmd(GC9A01A_NORON);
+
+  gc9a01_bus_acquire(dev);
+  int err = gc9a01_batch_send(dev, batch, false);
+  gc9a01_bus_release(dev);
+  return err;
+}
+
 void gc9a01_set_frame(const device *dev, const uint16_t x, const uint16_t y, const uint16_t endx, const uint16_t endy)
 {
-  uint8_t data[4];
-  data[0] = (x >> 8) & 0xFF;
-  data[1] = x & 0xFF;
-  data[2] = (endx >> 8) & 0xFF;
-  data[3] = endx & 0xFF;
-  gc9a01_write_cmd_data(dev, COL_ADDR_SET, data, sizeof(data));
+  gc9a01_batch_t batch;
+  gc9a01_encode_window(dev, batch, x, y, endx, endy);
+  gc9a01_batch_send(dev, batch, false);
+}
 
-  data[0] = (y >> 8) & 0xFF;
-  data[1] = y & 0xFF;
-  data[2] = (endy >> 8) & 0xFF;
-  data[3] = endy & 0xFF;
-  gc9a01_write_cmd_data(dev, ROW_ADDR_SET, data, sizeof(data));
+// Sends CASET/PASET/RAMWR as one batch and keeps chip select asserted for the pixel data. A pending
+// scroll offset goes out in the same batch and the window is moved to where its lines are in GRAM.
+int gc9a01_begin_write(const device *dev, uint16_t x, uint16_t y, uint16_t endx, uint16_t endy)
+{
+  auto *data = (gc9a01_data_t *)dev->data;
+
+  int err = gc9a01_scroll_on_x(data) ? gc9a01_scroll_map(dev, x, endx) : gc9a01_scroll_map(dev, y, endy);
+  if (err)
+  {
+    LOG_ERR("Window crosses the scroll area");
+    return err;
+  }
+
+  gc9a01_batch_t batch;
+  gc9a01_encode_scroll(dev, batch);
+  gc9a01_encode_window(dev, batch, x, y, endx, endy);
+  batch.cmd(GC9A01A_RAMWR);
+  err = gc9a01_batch_send(dev, batch, true);
+  if (!err)
+  {
+    data->scroll.offset = data->scroll.pending;
+  }
+  return err;
 }
 
-int gc9a01_init_display(const device *dev)
+// Bytes the panel takes for count pixels in the current color depth.
+static inline size_t gc9a01_pixel_bytes(const gc9a01_data_t *data, size_t count)
+{
+  return data->depth == GC9A01_COLOR_12_BIT ? color::rgb444_size(count) : count * sizeof(uint16_t);
+}
+
+// Fills the window with one color, the caller has to own the bus.
+int gc9a01_fill(const device *dev, uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint16_t color)
 {
   const auto *config = (gc9a01_config_t *)dev->config;
-  // reset diplsay
-  gpio_pin_set_dt(&config->reset_gpio, 0);
-  k_msleep(5);
-  gpio_pin_set_dt(&config->reset_gpio, 1);
-  k_msleep(150);
+  auto *data = (gc9a01_data_t *)dev->data;
+
+  if (w == 0 || h == 0)
+  {
+    return 0;
+  }
+
+  if (!data->fill_valid || data->fill_color != color)
+  {
+    if (data->depth == GC9A01_COLOR_12_BIT)
+    {
+      // the same pixel twice per three bytes, a trailing odd pixel just takes the first two
+      uint16_t c = color::rgb444(color);
+      const uint8_t pair[3] = {uint8_t(c >> 4), uint8_t(c << 4 | c >> 8), uint8_t(c)};
+      auto *bytes = (uint8_t *)data->fill_buf.data();
+      for (size_t i = 0; i < sizeof(data->fill_buf); i += sizeof(pair))
+      {
+        std::copy(pair, pair + sizeof(pair), &bytes[i]);
+      }
+    }
+    else
+    {
+      data->fill_buf.fill(sys_cpu_to_be16(color)); // the panel takes the high byte first
+    }
+    data->fill_color = color;
+    data->fill_valid = true;
+  }
+
+  int err = gc9a01_begin_write(dev, x, y, uint16_t(x + w - 1), uint16_t(y + h - 1));
+  size_t remaining = gc9a01_pixel_bytes(data, size_t(w) * h);
+  gpio_pin_set_dt(&config->dc_gpio, 1);
+  while (!err && remaining > 0)
+  {
+    size_t count = 0;
+    for (; count < data->fill_chain.size() && remaining > 0; ++count)
+    {
+      auto len = std::min(remaining, sizeof(data->fill_buf));
+      data->fill_chain[count] = {.buf = data->fill_buf.data(), .len = len};
+      remaining -= len;
+    }
+    struct spi_buf_set buf_set = {.buffers = data->fill_chain.data(), .count = count};
+    gc9a01_set_cs_hold(dev, remaining > 0);
+    if (spi_write(config->bus.bus, &data->bus_config, &buf_set) != 0)
+    {
+      LOG_ERR("Failed sending fill");
+      spi_release(config->bus.bus, &data->bus_config);
+      err = -EIO;
+    }
+  }
+  gc9a01_set_cs_hold(dev, false);
+  return err;
+}
+
+int gc9a01_fill_rect(const device *dev, uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint16_t color)
+{
+  if (x + w > DISPLAY_WIDTH || y + h > DISPLAY_HEIGHT)
+  {
+    return -EINVAL;
+  }
+
+  gc9a01_te_wait(dev);
+  gc9a01_bus_acquire(dev);
+  int err = gc9a01_fill(dev, x, y, w, h, color);
+  gc9a01_bus_release(dev);
+  return err;
+}
+
+void gc9a01_clear(const device *dev, uint16_t color)
+{
+  gc9a01_fill(dev, 0, 0, DISPLAY_WIDTH, DISPLAY_HEIGHT, color);
+}
+
+void gc9a01_clear(const device *dev, uint8_t r, uint8_t g, uint8_t b)
+{
+  gc9a01_clear(dev, color::rgb565(r, g, b));
+}
 
-  gc9a01_spi_resume(dev);
+enum gc9a01_init_step_t : uint8_t
+{
+  GC9A01_INIT_RELEASE_RESET,
+  GC9A01_INIT_CONFIGURE,
+};
+
+static void gc9a01_init_work_handler(k_work *work)
+{
+  auto *data = CONTAINER_OF(k_work_delayable_from_work(work), gc9a01_data_t, init_work);
+  const auto *dev = data->dev;
+  const auto *config = (gc9a01_config_t *)dev->config;
 
-  for (const auto &c : gc9a01_initcmds)
+  switch (data->init_step)
   {
-    gc9a01_write_cmd_data(dev, c.cmd, c.argv, c.argc);
+  case GC9A01_INIT_RELEASE_RESET:
+    gpio_pin_set_dt(&config->reset_gpio, 1);
+    data->init_step = GC9A01_INIT_CONFIGURE;
+    k_work_schedule(&data->init_work, K_MSEC(RESET_SETTLE_MS));
+    break;
+  case GC9A01_INIT_CONFIGURE:
+    gc9a01_bus_get(dev);
+    data->window.valid = false;
+    data->madctl = MADCTL_INIT;
+    data->scroll = {};
+    data->depth = GC9A01_COLOR_16_BIT;
+    data->fill_valid = false;
+
+    for (const auto &c : gc9a01_initcmds)
+    {
+      gc9a01_write_cmd_data(dev, c.cmd, c.argv, c.argc);
+    }
+    // GRAM isn't cleared, the display stays off after the reset until display_blanking_off once the
+    // first frame is out
+    gc9a01_write_cmd(dev, GC9A01A_SLPOUT);
+    data->sleep_changed_at = k_uptime_get();
+
+    // the first command after this waits for the panel in gc9a01_bus_acquire
+    gc9a01_bus_release(dev);
+    break;
   }
-  gc9a01_clear(dev, 0x0000);
-  gc9a01_write_cmd(dev, GC9A01A_DISPON);
-  k_msleep(150);
-  gc9a01_write_cmd(dev, GC9A01A_SLPOUT);
-  k_msleep(150);
+}
 
-  gc9a01_spi_suspend(dev);
+// Starts the reset and init sequence and returns right away, the first write waits for it to finish.
+int gc9a01_init_display(const device *dev)
+{
+  const auto *config = (gc9a01_config_t *)dev->config;
+  auto *data = (gc9a01_data_t *)dev->data;
 
+  k_sem_take(&data->bus_idle, K_FOREVER);
+  // reset diplsay
+  gpio_pin_set_dt(&config->reset_gpio, 0);
+  data->init_step = GC9A01_INIT_RELEASE_RESET;
+  k_work_schedule(&data->init_work, K_MSEC(RESET_PULSE_MS));
   return 0;
 }
 
 int gc9a01_init(const device *dev)
 {
   const auto *config = (gc9a01_config_t *)dev->config;
+  auto *data = (gc9a01_data_t *)dev->data;
+
+  data->dev = dev;
+  data->bus_config = config->bus.config;
+  k_sem_init(&data->bus_idle, 1, 1);
+  k_mutex_init(&data->bus_pm_lock);
+  k_work_init_delayable(&data->bus_idle_work, gc9a01_bus_idle_work_handler);
+  k_work_init_delayable(&data->init_work, gc9a01_init_work_handler);
+  // the bus is left to runtime pm when the spi driver supports it, otherwise it is driven directly
+  data->bus_runtime = pm_device_runtime_enable(config->bus.bus) == 0;
+
   if (!device_is_ready(config->reset_gpio.port))
   {
     LOG_ERR("Reset GPIO device not ready");
@@ -338,17 +1019,40 @@ int gc9a01_init(const device *dev)
   gpio_pin_configure_dt(&config->dc_gpio, GPIO_OUTPUT_INACTIVE);
   gpio_pin_configure_dt(&config->bl_gpio, GPIO_OUTPUT_INACTIVE); // Default to 0 brightness
 
+  k_sem_init(&data->te_sem, 0, 1);
+  if (gc9a01_has_te(dev))
+  {
+    if (!gpio_is_ready_dt(&config->te_gpio))
+    {
+      LOG_ERR("TE GPIO device not ready");
+      return -ENODEV;
+    }
+    gpio_pin_configure_dt(&config->te_gpio, GPIO_INPUT);
+    gpio_init_callback(&data->te_gpio_cb, gc9a01_te_isr_handler, BIT(config->te_gpio.pin));
+    if (gpio_add_callback(config->te_gpio.port, &data->te_gpio_cb) < 0)
+    {
+      LOG_ERR("Could not set TE gpio callback");
+      return -EIO;
+    }
+  }
+
   return gc9a01_init_display(dev);
 }
 
 int gc9a01_blanking_on(const device *dev)
 {
-  return gc9a01_write_cmd(dev, GC9A01A_DISPOFF);
+  gc9a01_bus_acquire(dev);
+  int err = gc9a01_write_cmd(dev, GC9A01A_DISPOFF);
+  gc9a01_bus_release(dev);
+  return err;
 }
 
 int gc9a01_blanking_off(const device *dev)
 {
-  return gc9a01_write_cmd(dev, GC9A01A_DISPON);
+  gc9a01_bus_acquire(dev);
+  int err = gc9a01_write_cmd(dev, GC9A01A_DISPON);
+  gc9a01_bus_release(dev);
+  return err;
 }
 
 int gc9a01_write_buf(const device *dev,
@@ -357,16 +1061,99 @@ int gc9a01_write_buf(const device *dev,
                      const display_buffer_descriptor *desc,
                      const void *buf)
 {
-  gc9a01_spi_resume(dev);
+  gc9a01_te_wait(dev);
+  gc9a01_bus_acquire(dev);
 
-  gc9a01_set_frame(dev, x, y, uint16_t(x + desc->width - 1), uint16_t(y + desc->height - 1));
+  auto *data = (gc9a01_data_t *)dev->data;
+  size_t len = gc9a01_pixel_bytes(data, desc->width * desc->height);
 
-  size_t len = desc->width * desc->height * 2; // TODO: look into desc->buf_size
+  int err = gc9a01_begin_write(dev, x, y, uint16_t(x + desc->width - 1), uint16_t(y + desc->height - 1));
+  if (!err)
+  {
+    err = gc9a01_write_data(dev, (uint8_t *)buf, len);
+  }
+
+  gc9a01_bus_release(dev);
+  return err;
+}
+
+#ifdef CONFIG_DISPLAY_GC9A01_ASYNC
+static void gc9a01_write_async_done(const device *spi_dev, int result, void *user_data)
+{
+  const auto *dev = (const device *)user_data;
+  auto *data = (gc9a01_data_t *)dev->data;
+
+  auto cb = data->write_cb;
+  auto *cb_user_data = data->write_user_data;
+
+  gc9a01_bus_release(dev);
+
+  if (result < 0)
+  {
+    LOG_ERR("Failed sending pixel data (err %d)", result);
+  }
+  if (cb != nullptr)
+  {
+    cb(dev, result, cb_user_data);
+  }
+}
+#endif
 
-  gc9a01_write_cmd_data(dev, GC9A01A_RAMWR, (uint8_t *)buf, len);
+int gc9a01_write_async(const device *dev,
+                       const uint16_t x,
+                       const uint16_t y,
+                       const display_buffer_descriptor *desc,
+                       const void *buf,
+                       gc9a01_write_cb_t cb,
+                       void *user_data)
+{
+#ifdef CONFIG_DISPLAY_GC9A01_ASYNC
+  const auto *config = (gc9a01_config_t *)dev->config;
+  auto *data = (gc9a01_data_t *)dev->data;
+
+  gc9a01_te_wait(dev);
+  // waits for the previous band to finish clocking out, the DC line can't change under it
+  gc9a01_bus_acquire(dev);
 
-  gc9a01_spi_suspend(dev);
+  int err = gc9a01_begin_write(dev, x, y, uint16_t(x + desc->width - 1), uint16_t(y + desc->height - 1));
+  if (err)
+  {
+    gc9a01_bus_release(dev);
+    return err;
+  }
+
+  data->write_cb = cb;
+  data->write_user_data = user_data;
+  data->xfer_buf = {.buf = (void *)buf, .len = gc9a01_pixel_bytes(data, desc->width * desc->height)};
+  data->xfer_buf_set = {.buffers = &data->xfer_buf, .count = 1};
+
+  gpio_pin_set_dt(&config->dc_gpio, 1);
+  err = spi_transceive_cb(config->bus.bus, &data->bus_config, &data->xfer_buf_set, NULL,
+                          gc9a01_write_async_done, (void *)dev);
+  if (err)
+  {
+    LOG_ERR("Failed starting async write (err %d)", err);
+    gc9a01_bus_release(dev);
+    return err;
+  }
   return 0;
+#else
+  int err = gc9a01_write_buf(dev, x, y, desc, buf);
+  if (cb != nullptr)
+  {
+    // the result went to cb, an error here would make the caller complete the write a second time
+    cb(dev, err, user_data);
+    return 0;
+  }
+  return err;
+#endif
+}
+
+void gc9a01_write_wait(const device *dev)
+{
+  auto *data = (gc9a01_data_t *)dev->data;
+  k_sem_take(&data->bus_idle, K_FOREVER);
+  k_sem_give(&data->bus_idle);
 }
 
 int gc9a01_read_buf(const struct device *dev,
@@ -407,7 +1194,7 @@ static int gc9a01_set_orientation(const struct device *dev,
                                   const enum display_orientation
                                       orientation)
 {
-  gc9a01_spi_resume(dev);
+  gc9a01_bus_acquire(dev);
   uint8_t data;
   switch (orientation)
   {
@@ -425,43 +1212,98 @@ static int gc9a01_set_orientation(const struct device *dev,
     break;
   }
   int err = gc9a01_write_cmd_data(dev, GC9A01A_MADCTL, &data, 1);
-  gc9a01_spi_suspend(dev);
+  auto *dev_data = (gc9a01_data_t *)dev->data;
+  // the window registers are interpreted differently after a MADCTL change
+  dev_data->window.valid = false;
+  dev_data->madctl = data;
+  // and the scroll area may now run the other way, start over without an offset
+  if (!err && dev_data->scroll.len > 0)
+  {
+    err = gc9a01_scroll_send_define(dev);
+  }
+  gc9a01_bus_release(dev);
   return err;
 }
 
+int gc9a01_set_color_depth(const device *dev, gc9a01_color_depth_t depth)
+{
+  auto *data = (gc9a01_data_t *)dev->data;
+
+  if (data->depth == depth)
+  {
+    return 0;
+  }
+
+  const uint8_t mode = depth == GC9A01_COLOR_12_BIT ? COLOR_MODE_12_BIT : COLOR_MODE_16_BIT;
+  // waits for the last band sent in the old depth
+  gc9a01_bus_acquire(dev);
+  int err = gc9a01_write_cmd_data(dev, GC9A01A_PIXFMT, &mode, 1);
+  if (!err)
+  {
+    data->depth = depth;
+    data->fill_valid = false;
+  }
+  gc9a01_bus_release(dev);
+  return err;
+}
+
+gc9a01_color_depth_t gc9a01_color_depth(const device *dev)
+{
+  auto *data = (gc9a01_data_t *)dev->data;
+  return data->depth;
+}
+
+// zephyr has no 12-bit pixel format, it is only reachable through gc9a01_set_color_depth
 static int gc9a01_set_pixel_format(const struct device *dev,
                                    const enum display_pixel_format pf)
 {
-  return -ENOTSUP;
+  if (pf != PIXEL_FORMAT_BGR_565)
+  {
+    return -ENOTSUP;
+  }
+  return gc9a01_set_color_depth(dev, GC9A01_COLOR_16_BIT);
 }
 
 int gc9a01_pm_action(const struct device *dev,
                      enum pm_device_action action)
 {
-  gc9a01_spi_resume(dev);
+  if (action == PM_DEVICE_ACTION_TURN_ON)
+  {
+    return gc9a01_init_display(dev);
+  }
+
+  auto *data = (gc9a01_data_t *)dev->data;
+  if ((action == PM_DEVICE_ACTION_RESUME || action == PM_DEVICE_ACTION_SUSPEND) && gc9a01_sleep_toggle_in(dev) > 0)
+  {
+    return -EAGAIN;
+  }
+  gc9a01_bus_acquire(dev);
 
   auto err = 0;
   switch (action)
   {
   case PM_DEVICE_ACTION_RESUME:
+    // the display stays off, blanking_off once the first frame is out. The 5 ms the panel needs
+    // after SLPOUT are left to the caller, see gc9a01_cmd_ready_in.
     err = gc9a01_write_cmd(dev, GC9A01A_SLPOUT);
-    k_msleep(5); // According to datasheet wait 5ms after SLPOUT before next command.
-    err = gc9a01_write_cmd(dev, GC9A01A_DISPON);
+    data->sleep_changed_at = k_uptime_get();
     break;
   case PM_DEVICE_ACTION_SUSPEND:
+  {
     err = gc9a01_write_cmd(dev, GC9A01A_DISPOFF);
-    err = gc9a01_write_cmd(dev, GC9A01A_SLPIN);
-    break;
-  case PM_DEVICE_ACTION_TURN_ON:
-    err = gc9a01_init(dev);
+    // SLPIN is sent even if DISPOFF failed, the first error is returned
+    auto slpin_err = gc9a01_write_cmd(dev, GC9A01A_SLPIN);
+    err = err < 0 ? err : slpin_err;
+    data->sleep_changed_at = k_uptime_get();
     break;
+  }
   case PM_DEVICE_ACTION_TURN_OFF:
     break;
   default:
     err = -ENOTSUP;
   }
 
-  gc9a01_spi_suspend(dev);
+  gc9a01_bus_release(dev);
 
   if (err < 0)
   {
@@ -489,6 +1331,7 @@ const struct gc9a01_config_t gc9a01_configa = {
     .dc_gpio = GPIO_DT_SPEC_INST_GET(0, dc_gpios),
     .bl_gpio = GPIO_DT_SPEC_INST_GET(0, bl_gpios),
     .reset_gpio = GPIO_DT_SPEC_INST_GET(0, reset_gpios),
+    .te_gpio = GPIO_DT_SPEC_INST_GET_OR(0, te_gpios, {}),
 };
 
 // fixes no user-provided default constructor
@@ -508,11 +1351,13 @@ const struct gc9a01_config_t gc9a01_configa = {
         .action_cb = pm_action_cb,                        \
   }
 
+static gc9a01_data_t gc9a01_dataa;
+
 PM_DEVICE_DT_INST_DEFINE(0, gc9a01_pm_action);
 DEVICE_DT_INST_DEFINE(0,
                       gc9a01_init,
                       PM_DEVICE_DT_INST_GET(0),
-                      NULL,
+                      &gc9a01_dataa,
                       &gc9a01_configa,
                       POST_KERNEL,
                       CONFIG_DISPLAY_INIT_PRIORITY,
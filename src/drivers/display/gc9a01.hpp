@@ -0,0 +1,106 @@
+#pragma once
+
+#include <zephyr/device.h>
+#include <zephyr/drivers/display.h>
+
+#include <cstdint>
+
+// Extensions to the zephyr display api for the out of tree GC9A01 driver.
+
+// Called once the pixel data of a gc9a01_write_async call has been clocked out.
+// With CONFIG_DISPLAY_GC9A01_ASYNC this runs in the SPI interrupt.
+using gc9a01_write_cb_t = void (*)(const device *dev, int result, void *user_data);
+
+// Starts writing buf to the given window and returns while the pixel data is still being sent.
+// buf must stay valid until cb is called. A following write waits for the previous one to finish.
+// Returns an error only if cb won't be called, otherwise the result is passed to cb.
+int gc9a01_write_async(const device *dev,
+                       const uint16_t x,
+                       const uint16_t y,
+                       const display_buffer_descriptor *desc,
+                       const void *buf,
+                       gc9a01_write_cb_t cb,
+                       void *user_data);
+
+// Blocks until any in flight async write has finished.
+void gc9a01_write_wait(const device *dev);
+
+// Fills a rectangle with one RGB565 color without a pixel buffer. A small buffer of the color is
+// repeated in a chained spi transfer, so a full screen takes a handful of transfers.
+int gc9a01_fill_rect(const device *dev, uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint16_t color);
+
+struct gc9a01_bus_stats_t
+{
+  uint32_t gets;     // references taken on the SPI bus power
+  uint32_t resumes;  // references that actually had to resume the bus
+  uint32_t suspends; // idle timeouts that suspended the bus
+};
+
+// Keeps the SPI bus resumed from the first to the last flush of a refresh. With te-gpios the first
+// flush after gc9a01_frame_begin is held back until the next TE edge.
+void gc9a01_frame_begin(const device *dev);
+void gc9a01_frame_end(const device *dev);
+
+// gets - resumes is the number of resume/suspend cycles saved by keeping the bus resumed.
+void gc9a01_get_bus_stats(const device *dev, gc9a01_bus_stats_t *stats);
+
+// Called from the TE interrupt.
+using gc9a01_te_cb_t = void (*)(const device *dev, void *user_data);
+
+// Calls cb once on the next tearing effect edge, a null cb cancels a pending one.
+// Returns -ENOTSUP when the panel has no te-gpios.
+int gc9a01_on_next_te(const device *dev, gc9a01_te_cb_t cb, void *user_data);
+
+// Hardware scrolling moves content along the panel's gate lines, which run along x or y depending on
+// the orientation.
+enum gc9a01_scroll_axis_t
+{
+  GC9A01_SCROLL_X,
+  GC9A01_SCROLL_Y,
+};
+
+gc9a01_scroll_axis_t gc9a01_scroll_axis(const device *dev);
+
+// Lets the lines [start, start + len) along the scroll axis scroll, the ones outside of it stay fixed.
+// Starts without an offset, content that was written with another one has to be redrawn.
+int gc9a01_scroll_define(const device *dev, uint16_t start, uint16_t len);
+
+// Shows the content of the scroll area moved by offset towards lower coordinates, wrapping around at
+// its end. Only the register is written with the next write, so that write already lands with the
+// new offset and the panel doesn't show the move before the newly exposed lines are sent. Writes keep
+// using display coordinates. Call from the thread that flushes.
+int gc9a01_scroll_to(const device *dev, uint16_t offset);
+
+// First line of the scroll area that lies behind the wrap with the current offset. A write has to
+// stay on one side of it and must not cross the edges of the scroll area either.
+uint16_t gc9a01_scroll_wrap(const device *dev);
+
+enum gc9a01_color_depth_t
+{
+  GC9A01_COLOR_16_BIT,
+  // RGB444, two pixels in three bytes, see color::pack_row_444
+  GC9A01_COLOR_12_BIT,
+};
+
+// Switches the pixel format of the interface, GRAM keeps what it shows. After switching to 12 bits the
+// write functions expect packed RGB444 pixels, desc->width and height still count pixels. Fills take
+// RGB565 colors in either depth. Call from the thread that flushes, a reset of the panel goes back
+// to 16 bits.
+int gc9a01_set_color_depth(const device *dev, gc9a01_color_depth_t depth);
+gc9a01_color_depth_t gc9a01_color_depth(const device *dev);
+
+// Low power always-on mode: only the lines [start, end] along the scroll axis are driven, with eight
+// colors and the frame rate from CONFIG_DISPLAY_GC9A01_AMBIENT_FRAMERATE. The rest of GRAM is kept,
+// gc9a01_ambient_off goes back to normal mode with it.
+int gc9a01_ambient_on(const device *dev, uint16_t start, uint16_t end);
+int gc9a01_ambient_off(const device *dev);
+
+// PM_DEVICE_ACTION_RESUME only takes the panel out of sleep, it stays blanked until
+// display_blanking_off so the old contents of GRAM aren't shown. Neither it nor the reset at init
+// blocks for the panel's settle times. RESUME and SUSPEND fail with -EAGAIN until
+// gc9a01_sleep_toggle_in is 0, and the next command waits for what is left of gc9a01_cmd_ready_in.
+
+// Milliseconds until the panel takes commands after SLPIN or SLPOUT.
+int32_t gc9a01_cmd_ready_in(const device *dev);
+// Milliseconds until the panel can be put to sleep or woken again.
+int32_t gc9a01_sleep_toggle_in(const device *dev);
@@ -0,0 +1,303 @@
+#define DT_DRV_COMPAT buydisplay_gc9a01
+
+#include <zephyr/device.h>
+#include <zephyr/drivers/emul.h>
+#include <zephyr/drivers/gpio.h>
+#include <zephyr/drivers/gpio/gpio_emul.h>
+#include <zephyr/drivers/spi.h>
+#include <zephyr/drivers/spi_emul.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+
+#include "drivers/display/gc9a01_emul.hpp"
+
+#include <algorithm>
+#include <array>
+
+LOG_MODULE_REGISTER(gc9a01_emul, CONFIG_DISPLAY_LOG_LEVEL);
+
+enum EmulCommand : uint8_t
+{
+  SLPIN = 0x10,
+  SLPOUT = 0x11,
+  DISPOFF = 0x28,
+  DISPON = 0x29,
+  CASET = 0x2A,
+  PASET = 0x2B,
+  RAMWR = 0x2C,
+  VSCRSADD = 0x37,
+  COLMOD = 0x3A,
+  RAMWR_CONT = 0x3C,
+};
+
+constexpr uint8_t COLMOD_12_BIT = 0x03;
+
+constexpr auto DISPLAY_WIDTH = DT_INST_PROP(0, width);
+constexpr auto DISPLAY_HEIGHT = DT_INST_PROP(0, height);
+
+struct gc9a01_emul_cfg_t
+{
+  gpio_dt_spec dc_gpio;
+  uint32_t frequency;
+};
+
+struct gc9a01_emul_data_t
+{
+  // command currently being decoded and its arguments
+  uint8_t cmd;
+  std::array<uint8_t, 4> args;
+  size_t argc;
+
+  uint16_t x, y, endx, endy;
+  uint16_t cur_x, cur_y;
+  // bytes of a pixel, or a 12-bit pair, split across two transfers
+  std::array<uint8_t, 3> partial;
+  size_t partial_len;
+  bool packed_12;
+
+  bool awake;
+  bool on;
+
+  std::array<uint16_t, DISPLAY_WIDTH * DISPLAY_HEIGHT> framebuffer;
+  gc9a01_emul_stats_t stats;
+};
+
+static void gc9a01_emul_pixel(gc9a01_emul_data_t *data, uint16_t pixel);
+static uint16_t gc9a01_emul_widen(uint16_t c);
+
+static void gc9a01_emul_command(gc9a01_emul_data_t *data, uint8_t cmd)
+{
+  // a write of an odd number of 12-bit pixels ends with the first half of a pair
+  if (data->packed_12 && data->partial_len == 2)
+  {
+    gc9a01_emul_pixel(data, gc9a01_emul_widen(uint16_t(data->partial[0] << 4 | data->partial[1] >> 4)));
+  }
+
+  data->cmd = cmd;
+  data->argc = 0;
+  data->partial_len = 0;
+  data->stats.commands++;
+
+  switch (cmd)
+  {
+  case SLPIN:
+    data->awake = false;
+    break;
+  case SLPOUT:
+    data->awake = true;
+    break;
+  case DISPOFF:
+    data->on = false;
+    break;
+  case DISPON:
+    data->on = true;
+    break;
+  case CASET:
+  case PASET:
+    data->stats.windows++;
+    break;
+  case RAMWR:
+    data->cur_x = data->x;
+    data->cur_y = data->y;
+    data->stats.writes++;
+    break;
+  case RAMWR_CONT:
+    data->stats.writes++;
+    break;
+  case VSCRSADD:
+    data->stats.scrolls++;
+    break;
+  }
+}
+
+static void gc9a01_emul_pixel(gc9a01_emul_data_t *data, uint16_t pixel)
+{
+  if (data->cur_x < DISPLAY_WIDTH && data->cur_y < DISPLAY_HEIGHT)
+  {
+    data->framebuffer[data->cur_y * DISPLAY_WIDTH + data->cur_x] = pixel;
+  }
+  data->stats.pixels++;
+
+  // the panel wraps inside of the window like the real GRAM address counter
+  if (++data->cur_x > data->endx)
+  {
+    data->cur_x = data->x;
+    if (++data->cur_y > data->endy)
+    {
+      data->cur_y = data->y;
+    }
+  }
+}
+
+// RGB444 widened to RGB565 the way the panel does it, in wire order like the 16-bit pixels.
+static uint16_t gc9a01_emul_widen(uint16_t c)
+{
+  uint16_t r = c >> 8, g = c >> 4 & 0xF, b = c & 0xF;
+  uint16_t rgb = uint16_t((r << 1 | r >> 3) << 11 | (g << 2 | g >> 2) << 5 | (b << 1 | b >> 3));
+  return uint16_t(rgb << 8 | rgb >> 8);
+}
+
+static void gc9a01_emul_pixels(gc9a01_emul_data_t *data, const uint8_t *group)
+{
+  if (data->packed_12)
+  {
+    gc9a01_emul_pixel(data, gc9a01_emul_widen(uint16_t(group[0] << 4 | group[1] >> 4)));
+    gc9a01_emul_pixel(data, gc9a01_emul_widen(uint16_t((group[1] & 0xF) << 8 | group[2])));
+  }
+  else
+  {
+    // stored in wire order, two bytes as they appear in memory
+    gc9a01_emul_pixel(data, uint16_t(group[1] << 8 | group[0]));
+  }
+}
+
+static void gc9a01_emul_data(gc9a01_emul_data_t *data, const uint8_t *buf, size_t len)
+{
+  if (data->cmd == RAMWR || data->cmd == RAMWR_CONT)
+  {
+    // 16-bit pixels take two bytes, 12-bit ones come in pairs of three
+    size_t group = data->packed_12 ? 3 : 2;
+    for (size_t i = 0; i < len; ++i)
+    {
+      data->partial[data->partial_len++] = buf[i];
+      if (data->partial_len == group)
+      {
+        gc9a01_emul_pixels(data, data->partial.data());
+        data->partial_len = 0;
+      }
+    }
+    return;
+  }
+
+  if (data->cmd == COLMOD && len > 0 && data->argc == 0)
+  {
+    data->packed_12 = (buf[0] & 0x07) == COLMOD_12_BIT;
+  }
+
+  for (size_t i = 0; i < len && data->argc < data->args.size(); ++i)
+  {
+    data->args[data->argc++] = buf[i];
+  }
+  if (data->argc == 4)
+  {
+    uint16_t start = uint16_t(data->args[0] << 8 | data->args[1]);
+    uint16_t end = uint16_t(data->args[2] << 8 | data->args[3]);
+    if (data->cmd == CASET)
+    {
+      data->x = start;
+      data->endx = end;
+    }
+    else if (data->cmd == PASET)
+    {
+      data->y = start;
+      data->endy = end;
+    }
+  }
+}
+
+static int gc9a01_emul_io(const emul *target,
+                          const spi_config *config,
+                          const spi_buf_set *tx_bufs,
+                          const spi_buf_set *rx_bufs)
+{
+  const auto *cfg = (const gc9a01_emul_cfg_t *)target->cfg;
+  auto *data = (gc9a01_emul_data_t *)target->data;
+
+  if (tx_bufs == nullptr)
+  {
+    return -EIO;
+  }
+
+  // the driver sets DC before every transfer, one transfer never mixes commands and data
+  bool dc = gpio_emul_output_get(cfg->dc_gpio.port, cfg->dc_gpio.pin) == 1;
+  size_t total = 0;
+  data->stats.transactions++;
+
+  for (size_t b = 0; b < tx_bufs->count; ++b)
+  {
+    const auto &buf = tx_bufs->buffers[b];
+    const auto *bytes = (const uint8_t *)buf.buf;
+    total += buf.len;
+    if (bytes == nullptr)
+    {
+      continue;
+    }
+    if (dc)
+    {
+      gc9a01_emul_data(data, bytes, buf.len);
+    }
+    else
+    {
+      for (size_t i = 0; i < buf.len; ++i)
+      {
+        gc9a01_emul_command(data, bytes[i]);
+      }
+    }
+  }
+
+  if (dc)
+  {
+    data->stats.data_bytes += total;
+  }
+  else
+  {
+    data->stats.cmd_bytes += total;
+  }
+
+  // take as long as the real bus would so frame times measured on the host are meaningful
+  uint32_t us = uint32_t(uint64_t(total) * 8 * USEC_PER_SEC / cfg->frequency);
+  data->stats.bus_us += us;
+  if (IS_ENABLED(CONFIG_DISPLAY_GC9A01_EMUL_BUS_TIMING) && us > 0)
+  {
+    k_busy_wait(us);
+  }
+  return 0;
+}
+
+const uint16_t *gc9a01_emul_framebuffer(const emul *target)
+{
+  auto *data = (gc9a01_emul_data_t *)target->data;
+  return data->framebuffer.data();
+}
+
+void gc9a01_emul_get_stats(const emul *target, gc9a01_emul_stats_t *stats)
+{
+  auto *data = (gc9a01_emul_data_t *)target->data;
+  *stats = data->stats;
+}
+
+void gc9a01_emul_reset_stats(const emul *target)
+{
+  auto *data = (gc9a01_emul_data_t *)target->data;
+  data->stats = {};
+}
+
+bool gc9a01_emul_display_on(const emul *target)
+{
+  auto *data = (gc9a01_emul_data_t *)target->data;
+  return data->awake && data->on;
+}
+
+static int gc9a01_emul_init(const emul *target, const device *parent)
+{
+  auto *data = (gc9a01_emul_data_t *)target->data;
+
+  data->partial_len = 0;
+  data->endx = DISPLAY_WIDTH - 1;
+  data->endy = DISPLAY_HEIGHT - 1;
+  LOG_DBG("GC9A01 emulator on %s", parent->name);
+  return 0;
+}
+
+static spi_emul_api gc9a01_emul_api = {
+    .io = gc9a01_emul_io,
+};
+
+static gc9a01_emul_data_t gc9a01_emul_dataa;
+
+static const gc9a01_emul_cfg_t gc9a01_emul_cfga = {
+    .dc_gpio = GPIO_DT_SPEC_INST_GET(0, dc_gpios),
+    .frequency = DT_INST_PROP(0, spi_max_frequency),
+};
+
+EMUL_DT_INST_DEFINE(0, gc9a01_emul_init, &gc9a01_emul_dataa, &gc9a01_emul_cfga, &gc9a01_emul_api, nullptr);
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <zephyr/drivers/emul.h>
+
+#include <cstdint>
+
+// SPI emulator of the GC9A01 for native_sim. It decodes CASET/PASET/RAMWR into an in memory framebuffer
+// and counts what goes over the bus, so the render pipeline can be benchmarked on the host.
+
+struct gc9a01_emul_stats_t
+{
+  uint32_t transactions; // spi transfers, one per DC run
+  uint32_t commands;
+  uint32_t windows;      // CASET and PASET commands
+  uint32_t writes;       // RAMWR and RAMWR continue commands
+  uint32_t scrolls;      // VSCRSADD commands, the framebuffer stays in GRAM order
+  uint64_t cmd_bytes;    // bytes sent with DC low
+  uint64_t data_bytes;   // bytes sent with DC high, arguments and pixels
+  uint64_t pixels;
+  uint64_t bus_us;       // modelled time on the bus at spi-max-frequency
+};
+
+// Pixels as received, in the byte order of the wire.
+const uint16_t *gc9a01_emul_framebuffer(const emul *target);
+
+void gc9a01_emul_get_stats(const emul *target, gc9a01_emul_stats_t *stats);
+void gc9a01_emul_reset_stats(const emul *target);
+
+// Returns if the panel is out of sleep with the display on.
+bool gc9a01_emul_display_on(const emul *target);
@@ -7,6 +7,11 @@
 #include <zephyr/logging/log.h>
 #include <zephyr/pm/device.h>
 
+#include "drivers/input/cst816s.hpp"
+
+#include <algorithm>
+#include <cstring>
+
 constexpr uint8_t CST816S_CHIP_ID = 0xB4u;
 
 enum class Register : uint8_t
@@ -100,6 +105,10 @@ constexpr uint8_t CST816S_EVENT_BITS_POS = 0x06;
 
 constexpr uint8_t CST816S_RESET_DELAY_MS = 5; /* in ms */
 constexpr uint8_t CST816S_WAIT_DELAY_MS = 50; /* in ms */
+// without a touch for that long the chip drops to the low power scan, 2 s after reset
+constexpr uint8_t CST816S_LP_AUTO_SLEEP_S = 1;
+// a full input queue drops the event after that long instead of stalling the touch queue
+constexpr uint8_t CST816S_REPORT_TIMEOUT_MS = 10;
 
 struct cst816s_config
 {
@@ -111,10 +120,50 @@ struct cst816s_config
 #endif
 };
 
+enum cst816s_reset_step_t : uint8_t
+{
+  CST816S_RESET_RELEASE,
+  CST816S_RESET_CONFIGURE,
+};
+
 struct cst816s_data
 {
   const device *dev;
   struct k_work work;
+  // the reset pulse and the chip's boot time are waited for by delayable work, touch data is ignored
+  // until the chip is configured again
+  struct k_work_delayable reset_work;
+  cst816s_reset_step_t reset_step;
+  bool ready;
+
+  // suspended with the low power scan running, the next interrupt calls wake_cb
+  cst816s_wake_cb_t wake_cb;
+  void *wake_user_data;
+  atomic_t wake_armed;
+  // the chip kept its configuration while suspended and resumes without a reset
+  bool scanning;
+
+  // chip id checked and the configuration read after the first reset, written as is after later ones
+  bool verified;
+  uint8_t motion_mask;
+  uint8_t irq_control;
+  uint8_t auto_sleep_time;
+
+  // cycle count of the last interrupt, the latency is measured from it to the input report
+  uint32_t irq_cycles;
+#ifdef CONFIG_I2C_CALLBACK
+  // burst read started from the interrupt, work reports it once it completed
+  i2c_msg xfer_msgs[2];
+  uint8_t xfer_reg;
+  uint8_t xfer_buf[6];
+  int xfer_result;
+  atomic_t xfer_busy;
+  atomic_t xfer_done;
+  // an interrupt came in while the read was in flight, the registers hold a newer sample
+  atomic_t xfer_again;
+#endif
+  k_spinlock stats_lock;
+  cst816s_stats_t stats;
 
 #ifdef CONFIG_INPUT_CST816S_INTERRUPT
   gpio_callback int_gpio_cb;
@@ -133,17 +182,44 @@ struct cst816s_output
 
 LOG_MODULE_REGISTER(cst816s, CONFIG_INPUT_LOG_LEVEL);
 
-static int cst816s_process(const device *dev)
+// touch is read and reported on its own queue so it doesn't wait behind rendering or bluetooth on
+// the system work queue, all instances share it
+K_THREAD_STACK_DEFINE(cst816s_stack, CONFIG_INPUT_CST816S_THREAD_STACK_SIZE);
+static k_work_q cst816s_work_q;
+
+static void cst816s_count(cst816s_data *data, bool ok, bool async)
 {
-  const auto *config = (cst816s_config *)dev->config;
+  auto us = uint32_t(k_cyc_to_us_floor64(k_cycle_get_32() - data->irq_cycles));
 
-  cst816s_output output;
-  if (i2c_burst_read_dt(&config->i2c, (uint8_t)Register::GestureID, (uint8_t *)&output, sizeof(cst816s_output)) < 0)
+  k_spinlock_key_t key = k_spin_lock(&data->stats_lock);
+  if (!ok)
   {
-    LOG_ERR("Could not read data");
-    return -ENODATA;
+    data->stats.errors++;
+  }
+  else
+  {
+    data->stats.samples++;
+    data->stats.async_reads += async ? 1 : 0;
+    data->stats.latency_sum_us += us;
+    data->stats.latency_max_us = std::max(data->stats.latency_max_us, us);
   }
+  k_spin_unlock(&data->stats_lock, key);
+}
 
+static void cst816s_input(const device *dev, uint8_t type, uint16_t code, int32_t value, bool sync)
+{
+  auto *data = (cst816s_data *)dev->data;
+
+  if (input_report(dev, type, code, value, sync, K_MSEC(CST816S_REPORT_TIMEOUT_MS)) < 0)
+  {
+    k_spinlock_key_t key = k_spin_lock(&data->stats_lock);
+    data->stats.dropped++;
+    k_spin_unlock(&data->stats_lock, key);
+  }
+}
+
+static void cst816s_report(const device *dev, const cst816s_output &output)
+{
   uint16_t x = sys_be16_to_cpu(output.x) & 0x0FFF;
   uint16_t y = sys_be16_to_cpu(output.y) & 0x0FFF;
   uint8_t event = (output.x & 0xFF) >> CST816S_EVENT_BITS_POS;
@@ -160,48 +236,150 @@ static int cst816s_process(const device *dev)
 
   if (pressed)
   {
-    input_report_abs(dev, INPUT_ABS_X, x, false, K_FOREVER);
-    input_report_abs(dev, INPUT_ABS_Y, y, false, K_FOREVER);
-    input_report_key(dev, INPUT_BTN_TOUCH, 1, true, K_FOREVER);
+    cst816s_input(dev, INPUT_EV_ABS, INPUT_ABS_X, x, false);
+    cst816s_input(dev, INPUT_EV_ABS, INPUT_ABS_Y, y, false);
+    cst816s_input(dev, INPUT_EV_KEY, INPUT_BTN_TOUCH, 1, true);
+    return;
   }
-  else
+
+  uint16_t gesture = 0;
+  switch (output.gesture)
   {
-    input_report_key(dev, INPUT_BTN_TOUCH, 0, true, K_FOREVER);
-    switch (output.gesture)
-    {
-    case Gesture::UpSliding:
-      input_report_key(dev, INPUT_BTN_NORTH, 0, true, K_FOREVER);
-      break;
-    case Gesture::DownSliding:
-      input_report_key(dev, INPUT_BTN_SOUTH, 0, true, K_FOREVER);
-      break;
-    case Gesture::LeftSlide:
-      input_report_key(dev, INPUT_BTN_WEST, 0, true, K_FOREVER);
-      break;
-    case Gesture::RightSlide:
-      input_report_key(dev, INPUT_BTN_EAST, 0, true, K_FOREVER);
-      break;
-    case Gesture::Click:
-      // input_report_key(dev, INPUT_BTN_MIDDLE, 0, true, K_FOREVER);
-      break;
-    case Gesture::DoubleClick:
-      // input_report_key(dev, INPUT_BTN_MIDDLE, 0, true, K_FOREVER);
-      break;
-    case Gesture::LongPress:
-      // input_report_key(dev, INPUT_BTN_MIDDLE, 0, true, K_FOREVER);
-      break;
-    case Gesture::None:
-      break;
-    }
+  case Gesture::UpSliding:
+    gesture = INPUT_BTN_NORTH;
+    break;
+  case Gesture::DownSliding:
+    gesture = INPUT_BTN_SOUTH;
+    break;
+  case Gesture::LeftSlide:
+    gesture = INPUT_BTN_WEST;
+    break;
+  case Gesture::RightSlide:
+    gesture = INPUT_BTN_EAST;
+    break;
+  case Gesture::Click:
+    gesture = CST816S_BTN_CLICK;
+    break;
+  case Gesture::DoubleClick:
+    gesture = CST816S_BTN_DOUBLE_CLICK;
+    break;
+  case Gesture::LongPress:
+    gesture = CST816S_BTN_LONG_PRESS;
+    break;
+  case Gesture::None:
+    break;
+  }
+
+  // the gesture ends the frame of the release, so it is a single sample for the pointer input
+  cst816s_input(dev, INPUT_EV_KEY, INPUT_BTN_TOUCH, 0, gesture == 0);
+  if (gesture != 0)
+  {
+    cst816s_input(dev, INPUT_EV_KEY, gesture, 1, true);
   }
+}
 
+static int cst816s_process(const device *dev)
+{
+  const auto *config = (cst816s_config *)dev->config;
+  auto *data = (cst816s_data *)dev->data;
+
+  cst816s_output output;
+  if (i2c_burst_read_dt(&config->i2c, (uint8_t)Register::GestureID, (uint8_t *)&output, sizeof(cst816s_output)) < 0)
+  {
+    LOG_ERR("Could not read data");
+    cst816s_count(data, false, false);
+    return -ENODATA;
+  }
+
+  cst816s_report(dev, output);
+  cst816s_count(data, true, false);
   return 0;
 }
 
+#ifdef CONFIG_I2C_CALLBACK
+static_assert(sizeof(cst816s_output) == sizeof(cst816s_data::xfer_buf));
+
+static void cst816s_read_done(const device *bus, int result, void *user_data)
+{
+  auto *data = (cst816s_data *)user_data;
+
+  data->xfer_result = result;
+  atomic_set(&data->xfer_done, 1);
+  k_work_submit_to_queue(&cst816s_work_q, &data->work);
+}
+
+// Starts the burst read of the touch data right from the interrupt. Fails when the bus driver has no
+// async transfers or is busy, the read is then done on the queue.
+static int cst816s_read_async(const device *dev)
+{
+  const auto *config = (cst816s_config *)dev->config;
+  auto *data = (cst816s_data *)dev->data;
+
+  if (!atomic_cas(&data->xfer_busy, 0, 1))
+  {
+    atomic_set(&data->xfer_again, 1);
+    return 0;
+  }
+
+  data->xfer_reg = (uint8_t)Register::GestureID;
+  data->xfer_msgs[0] = {.buf = &data->xfer_reg, .len = 1, .flags = I2C_MSG_WRITE};
+  data->xfer_msgs[1] = {.buf = data->xfer_buf, .len = sizeof(data->xfer_buf), .flags = I2C_MSG_RESTART | I2C_MSG_READ | I2C_MSG_STOP};
+  int err = i2c_transfer_cb(config->i2c.bus, data->xfer_msgs, ARRAY_SIZE(data->xfer_msgs), config->i2c.addr,
+                            cst816s_read_done, data);
+  if (err)
+  {
+    atomic_clear(&data->xfer_busy);
+  }
+  return err;
+}
+
+// Reports a finished async read, returns false when there was none.
+static bool cst816s_process_async(const device *dev)
+{
+  auto *data = (cst816s_data *)dev->data;
+
+  if (!atomic_cas(&data->xfer_done, 1, 0))
+  {
+    return false;
+  }
+
+  if (data->xfer_result < 0)
+  {
+    LOG_ERR("Could not read data (err %d)", data->xfer_result);
+    cst816s_count(data, false, true);
+  }
+  else
+  {
+    cst816s_output output;
+    memcpy(&output, data->xfer_buf, sizeof(output));
+    cst816s_report(dev, output);
+    cst816s_count(data, true, true);
+  }
+  atomic_clear(&data->xfer_busy);
+
+  // the sample behind the interrupt that found the bus busy is read right away
+  if (atomic_cas(&data->xfer_again, 1, 0))
+  {
+    cst816s_process(dev);
+  }
+  return true;
+}
+#endif
+
 static void cst816s_work_handler(k_work *work)
 {
   struct cst816s_data *data = CONTAINER_OF(work, struct cst816s_data, work);
 
+  if (!data->ready)
+  {
+    return;
+  }
+#ifdef CONFIG_I2C_CALLBACK
+  if (cst816s_process_async(data->dev))
+  {
+    return;
+  }
+#endif
   cst816s_process(data->dev);
 }
 
@@ -210,49 +388,69 @@ static void cst816s_isr_handler(const device *dev, gpio_callback *cb, uint32_t m
 {
   cst816s_data *data = CONTAINER_OF(cb, cst816s_data, int_gpio_cb);
 
-  k_work_submit(&data->work);
+  data->irq_cycles = k_cycle_get_32();
+  if (atomic_cas(&data->wake_armed, 1, 0))
+  {
+    data->wake_cb(data->dev, data->wake_user_data);
+    return;
+  }
+#ifdef CONFIG_I2C_CALLBACK
+  if (data->ready && cst816s_read_async(data->dev) == 0)
+  {
+    return;
+  }
+#endif
+  k_work_submit_to_queue(&cst816s_work_q, &data->work);
 }
 #else
 static void cst816s_timer_handler(k_timer *timer)
 {
   cst816s_data *data = CONTAINER_OF(timer, cst816s_data, timer);
 
-  k_work_submit(&data->work);
+  data->irq_cycles = k_cycle_get_32();
+  k_work_submit_to_queue(&cst816s_work_q, &data->work);
 }
 #endif
 
-static void cst816s_chip_reset(const device *dev)
+// Writes the cached gesture, interrupt and auto sleep configuration.
+static int cst816s_chip_write_config(const device *dev)
 {
   const auto *config = (cst816s_config *)dev->config;
-
-  if (gpio_is_ready_dt(&config->rst_gpio))
+  auto *data = (cst816s_data *)dev->data;
+  const struct
+  {
+    Register reg;
+    uint8_t value;
+  } writes[] = {
+      {Register::MotionMask, data->motion_mask},
+      {Register::IRQControl, data->irq_control},
+      {Register::AutoSleepTime, data->auto_sleep_time},
+  };
+
+  for (const auto &write : writes)
   {
-    if (gpio_pin_configure_dt(&config->rst_gpio, GPIO_OUTPUT_INACTIVE) < 0)
+    if (i2c_reg_write_byte_dt(&config->i2c, (uint8_t)write.reg, write.value) < 0)
     {
-      LOG_ERR("Could not configure reset GPIO pin");
-      return;
+      LOG_ERR("Could not write configuration");
+      return -ENODATA;
     }
-
-    gpio_pin_set_dt(&config->rst_gpio, 1);
-    k_msleep(CST816S_RESET_DELAY_MS);
-    gpio_pin_set_dt(&config->rst_gpio, 0);
-    k_msleep(CST816S_WAIT_DELAY_MS);
   }
+  return 0;
 }
 
-static int cst816s_chip_init(const device *dev)
+// Checks the chip id and configures the chip after a reset. Both are only read from the chip after
+// the first reset, every later one writes the cached configuration right away.
+static int cst816s_chip_configure(const device *dev)
 {
   const auto *config = (cst816s_config *)dev->config;
-  uint8_t chip_id;
-
-  cst816s_chip_reset(dev);
+  auto *data = (cst816s_data *)dev->data;
 
-  if (!device_is_ready(config->i2c.bus))
+  if (data->verified)
   {
-    LOG_ERR("I2C bus %s not ready", config->i2c.bus->name);
-    return -ENODEV;
+    return cst816s_chip_write_config(dev);
   }
 
+  uint8_t chip_id;
   if (i2c_reg_read_byte_dt(&config->i2c, (uint8_t)Register::ChipID, &chip_id) < 0)
   {
     LOG_ERR("failed reading chip id");
@@ -265,22 +463,103 @@ static int cst816s_chip_init(const device *dev)
     return -ENODEV;
   }
 
-  if (i2c_reg_update_byte_dt(&config->i2c, (uint8_t)Register::MotionMask,
-                             (uint8_t)Motion::DClick | (uint8_t)Motion::CON_LR | (uint8_t)Motion::CON_UD,
-                             (uint8_t)Motion::DClick | (uint8_t)Motion::CON_LR | (uint8_t)Motion::CON_UD) < 0)
+  if (i2c_reg_read_byte_dt(&config->i2c, (uint8_t)Register::MotionMask, &data->motion_mask) < 0 ||
+      i2c_reg_read_byte_dt(&config->i2c, (uint8_t)Register::IRQControl, &data->irq_control) < 0 ||
+      i2c_reg_read_byte_dt(&config->i2c, (uint8_t)Register::AutoSleepTime, &data->auto_sleep_time) < 0)
   {
-    LOG_ERR("Could not set motion mask");
+    LOG_ERR("Could not read configuration");
     return -ENODATA;
   }
+  data->motion_mask |= (uint8_t)Motion::DClick | (uint8_t)Motion::CON_LR | (uint8_t)Motion::CON_UD;
+  data->irq_control |= (uint8_t)IRQ::EnableMotion | (uint8_t)IRQ::EnableTouch | (uint8_t)IRQ::EnableChange;
 
-  if (i2c_reg_update_byte_dt(&config->i2c, (uint8_t)Register::IRQControl,
-                             (uint8_t)IRQ::EnableMotion | (uint8_t)IRQ::EnableTouch | (uint8_t)IRQ::EnableChange,
-                             (uint8_t)IRQ::EnableMotion | (uint8_t)IRQ::EnableTouch | (uint8_t)IRQ::EnableChange) < 0)
+  int err = cst816s_chip_write_config(dev);
+  data->verified = err == 0;
+  return err;
+}
+
+#ifdef CONFIG_INPUT_CST816S_WAKE
+// Tunes the scan the chip falls back to after CST816S_LP_AUTO_SLEEP_S without a touch. Its touch
+// interrupts keep coming from there.
+static int cst816s_lp_configure(const device *dev)
+{
+  const auto *config = (cst816s_config *)dev->config;
+  const struct
   {
-    LOG_ERR("Could not enable irq");
-    return -ENODATA;
+    Register reg;
+    uint8_t value;
+  } writes[] = {
+      {Register::LPScanTH, CONFIG_INPUT_CST816S_LP_SCAN_THRESHOLD},
+      {Register::LPScanFreq, CONFIG_INPUT_CST816S_LP_SCAN_FREQ},
+      {Register::AutoSleepTime, CST816S_LP_AUTO_SLEEP_S},
+      {Register::DISAutoSleep, 0},
+  };
+
+  for (const auto &write : writes)
+  {
+    if (i2c_reg_write_byte_dt(&config->i2c, (uint8_t)write.reg, write.value) < 0)
+    {
+      LOG_ERR("Could not configure low power scan");
+      return -ENODATA;
+    }
   }
+  return 0;
+}
+#endif
+
+static void cst816s_reset_work_handler(k_work *work)
+{
+  auto *data = CONTAINER_OF(k_work_delayable_from_work(work), cst816s_data, reset_work);
+  const auto *config = (cst816s_config *)data->dev->config;
 
+  switch (data->reset_step)
+  {
+  case CST816S_RESET_RELEASE:
+    gpio_pin_set_dt(&config->rst_gpio, 0);
+    data->reset_step = CST816S_RESET_CONFIGURE;
+    k_work_schedule_for_queue(&cst816s_work_q, &data->reset_work, K_MSEC(CST816S_WAIT_DELAY_MS));
+    break;
+  case CST816S_RESET_CONFIGURE:
+    if (cst816s_chip_configure(data->dev) == 0)
+    {
+      data->ready = true;
+    }
+    break;
+  }
+}
+
+// Starts a reset of the chip, it is configured once it has booted. Returns right away.
+static int cst816s_chip_init(const device *dev)
+{
+  const auto *config = (cst816s_config *)dev->config;
+  auto *data = (cst816s_data *)dev->data;
+
+  if (!device_is_ready(config->i2c.bus))
+  {
+    LOG_ERR("I2C bus %s not ready", config->i2c.bus->name);
+    return -ENODEV;
+  }
+
+  data->ready = false;
+  k_spinlock_key_t key = k_spin_lock(&data->stats_lock);
+  data->stats.resets++;
+  k_spin_unlock(&data->stats_lock, key);
+
+  if (!gpio_is_ready_dt(&config->rst_gpio))
+  {
+    data->reset_step = CST816S_RESET_CONFIGURE;
+    k_work_reschedule_for_queue(&cst816s_work_q, &data->reset_work, K_NO_WAIT);
+    return 0;
+  }
+
+  if (gpio_pin_configure_dt(&config->rst_gpio, GPIO_OUTPUT_INACTIVE) < 0)
+  {
+    LOG_ERR("Could not configure reset GPIO pin");
+    return -EIO;
+  }
+  gpio_pin_set_dt(&config->rst_gpio, 1);
+  data->reset_step = CST816S_RESET_RELEASE;
+  k_work_reschedule_for_queue(&cst816s_work_q, &data->reset_work, K_MSEC(CST816S_RESET_DELAY_MS));
   return 0;
 }
 
@@ -288,8 +567,18 @@ static int cst816s_init(const device *dev)
 {
   auto *data = (cst816s_data *)dev->data;
 
+  static bool queue_started;
+  if (!queue_started)
+  {
+    k_work_queue_start(&cst816s_work_q, cst816s_stack, K_THREAD_STACK_SIZEOF(cst816s_stack),
+                       CONFIG_INPUT_CST816S_THREAD_PRIORITY, nullptr);
+    k_thread_name_set(&cst816s_work_q.thread, "cst816s");
+    queue_started = true;
+  }
+
   data->dev = dev;
   k_work_init(&data->work, cst816s_work_handler);
+  k_work_init_delayable(&data->reset_work, cst816s_reset_work_handler);
 
   LOG_DBG("Initialize CST816S");
 
@@ -329,6 +618,30 @@ static int cst816s_init(const device *dev)
   return cst816s_chip_init(dev);
 };
 
+void cst816s_set_wake_callback(const device *dev, cst816s_wake_cb_t cb, void *user_data)
+{
+  auto *data = (cst816s_data *)dev->data;
+  atomic_clear(&data->wake_armed);
+  data->wake_user_data = user_data;
+  data->wake_cb = cb;
+}
+
+void cst816s_get_stats(const device *dev, cst816s_stats_t *stats)
+{
+  auto *data = (cst816s_data *)dev->data;
+  k_spinlock_key_t key = k_spin_lock(&data->stats_lock);
+  *stats = data->stats;
+  k_spin_unlock(&data->stats_lock, key);
+}
+
+void cst816s_reset_stats(const device *dev)
+{
+  auto *data = (cst816s_data *)dev->data;
+  k_spinlock_key_t key = k_spin_lock(&data->stats_lock);
+  data->stats = {};
+  k_spin_unlock(&data->stats_lock, key);
+}
+
 #ifdef CONFIG_PM_DEVICE
 static int cst816s_pm_action(const device *dev, enum pm_device_action action)
 {
@@ -342,6 +655,24 @@ static int cst816s_pm_action(const device *dev, enum pm_device_action action)
   case PM_DEVICE_ACTION_SUSPEND:
   {
     LOG_DBG("State changed to suspended");
+    auto *data = (cst816s_data *)dev->data;
+    k_work_cancel_delayable(&data->reset_work);
+    [[maybe_unused]] bool configured = data->ready;
+    data->ready = false;
+    status = 0;
+#ifdef CONFIG_INPUT_CST816S_WAKE
+    // a configured chip is left scanning, a chip that is still booting has nothing to scan with
+    if (configured && data->wake_cb != nullptr)
+    {
+      if (cst816s_lp_configure(dev) == 0)
+      {
+        data->scanning = true;
+        atomic_set(&data->wake_armed, 1);
+        break;
+      }
+      LOG_WRN("No wake on touch, holding the chip in reset");
+    }
+#endif
     if (device_is_ready(config->rst_gpio.port))
     {
       status = gpio_pin_set_dt(&config->rst_gpio, 1);
@@ -352,6 +683,24 @@ static int cst816s_pm_action(const device *dev, enum pm_device_action action)
   case PM_DEVICE_ACTION_RESUME:
   {
     LOG_DBG("State changed to active");
+    auto *data = (cst816s_data *)dev->data;
+    atomic_clear(&data->wake_armed);
+    // out of the low power scan the chip only needs its auto sleep time back, it is reset when it
+    // doesn't answer
+    if (data->scanning)
+    {
+      data->scanning = false;
+      if (cst816s_chip_write_config(dev) == 0)
+      {
+        data->ready = true;
+        k_spinlock_key_t key = k_spin_lock(&data->stats_lock);
+        data->stats.warm_resumes++;
+        k_spin_unlock(&data->stats_lock, key);
+        status = 0;
+        break;
+      }
+      LOG_WRN("Warm resume failed, resetting the chip");
+    }
     status = cst816s_chip_init(dev);
 
     break;
@@ -393,8 +742,8 @@ static int cst816s_pm_action(const device *dev, enum pm_device_action action)
                                                                                           \
   PM_DEVICE_DT_INST_DEFINE(index, cst816s_pm_action);                                     \
                                                                                           \
-  DEVICE_DT_INST_DEFINE(index, cst816s_init, NULL, &cst816s_data_##index,                 \
-                        &cst816s_config_##index, POST_KERNEL, CONFIG_INPUT_INIT_PRIORITY, \
-                        NULL);
+  DEVICE_DT_INST_DEFINE(index, cst816s_init, PM_DEVICE_DT_INST_GET(index),               \
+                        &cst816s_data_##index, &cst816s_config_##index, POST_KERNEL,     \
+                        CONFIG_INPUT_INIT_PRIORITY, NULL);
 
 DT_INST_FOREACH_STATUS_OKAY(CST816S_DEFINE)
\ No newline at end of file
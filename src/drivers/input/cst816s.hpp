@@ -0,0 +1,37 @@
+#pragma once
+
+#include <zephyr/device.h>
+#include <zephyr/input/input.h>
+
+#include <cstdint>
+
+// Extensions to the zephyr input api for the out of tree CST816S driver.
+
+// Gestures the controller recognized are reported as a key event in the frame of the release: swipes
+// as INPUT_BTN_NORTH, _SOUTH, _WEST and _EAST in controller coordinates, taps with the codes below.
+constexpr uint16_t CST816S_BTN_CLICK = INPUT_BTN_LEFT;
+constexpr uint16_t CST816S_BTN_DOUBLE_CLICK = INPUT_BTN_MIDDLE;
+constexpr uint16_t CST816S_BTN_LONG_PRESS = INPUT_BTN_RIGHT;
+
+struct cst816s_stats_t
+{
+  uint32_t samples;        // touch samples read and reported
+  uint32_t async_reads;    // of those, read with an i2c transfer started from the interrupt
+  uint32_t errors;         // failed reads
+  uint32_t dropped;        // input events the input queue had no room for
+  uint32_t latency_max_us;
+  uint64_t latency_sum_us; // from the interrupt, or poll timer, to the input report
+  uint32_t warm_resumes;   // resumes from the low power scan, ready right away
+  uint32_t resets;         // at boot and on resumes that had to reset the chip, ready after 55 ms
+};
+
+// Called from the interrupt when a touch wakes the suspended controller.
+using cst816s_wake_cb_t = void (*)(const device *dev, void *user_data);
+
+// With CONFIG_INPUT_CST816S_WAKE the suspended controller is left scanning at low power instead of
+// being held in reset, and cb is called once on the first touch. Resuming from there keeps the chip's
+// configuration and skips the reset. A null cb holds the chip in reset while suspended.
+void cst816s_set_wake_callback(const device *dev, cst816s_wake_cb_t cb, void *user_data);
+
+void cst816s_get_stats(const device *dev, cst816s_stats_t *stats);
+void cst816s_reset_stats(const device *dev);
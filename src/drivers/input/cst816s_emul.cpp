@@ -0,0 +1,316 @@
+#define DT_DRV_COMPAT hynitron_cst816s
+
+#include <zephyr/device.h>
+#include <zephyr/drivers/emul.h>
+#include <zephyr/drivers/gpio.h>
+#include <zephyr/drivers/gpio/gpio_emul.h>
+#include <zephyr/drivers/i2c.h>
+#include <zephyr/drivers/i2c_emul.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+
+#include "drivers/input/cst816s_emul.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bitset>
+
+LOG_MODULE_REGISTER(cst816s_emul, CONFIG_INPUT_LOG_LEVEL);
+
+constexpr uint8_t CST816S_EMUL_CHIP_ID = 0xB4u;
+
+enum EmulRegister : uint8_t
+{
+  GestureID = 0x01,
+  FingerNum = 0x02,
+  XPosH = 0x03,
+  XPosL = 0x04,
+  YPosH = 0x05,
+  YPosL = 0x06,
+  ChipID = 0xA7,
+  LPScanTH = 0xF5,
+  LPScanFreq = 0xF7,
+  AutoSleepTime = 0xF9,
+  DISAutoSleep = 0xFE,
+};
+
+constexpr uint8_t CST816S_EMUL_EVENT_BITS_POS = 0x06;
+// the interrupt is a short low pulse on the real chip
+constexpr uint32_t CST816S_EMUL_IRQ_PULSE_US = 10;
+
+struct cst816s_emul_cfg_t
+{
+  gpio_dt_spec int_gpio;
+  gpio_dt_spec rst_gpio;
+};
+
+struct cst816s_emul_data_t
+{
+  const emul *target;
+  std::array<uint8_t, 256> regs;
+  // registers the driver wrote since the chip last left reset
+  std::bitset<256> written;
+  uint8_t reg_ptr;
+
+  k_work_delayable play_work;
+  const cst816s_emul_sample_t *trace;
+  size_t trace_len;
+  size_t trace_pos;
+
+  bool sample_pending;
+  uint32_t irq_cycles;
+  cst816s_emul_stats_t stats;
+
+  // the power state is accounted up to accounted_ms whenever the driver or a sample touches the chip
+  int64_t accounted_ms;
+  int64_t activity_ms;
+};
+
+static void cst816s_emul_reset_regs(cst816s_emul_data_t *data)
+{
+  data->regs.fill(0);
+  data->written.reset();
+  data->regs[ChipID] = CST816S_EMUL_CHIP_ID;
+  data->regs[LPScanTH] = 48;
+  data->regs[LPScanFreq] = 7;
+  data->regs[AutoSleepTime] = 2;
+}
+
+static bool cst816s_emul_in_reset(const cst816s_emul_cfg_t *cfg)
+{
+  if (cfg->rst_gpio.port == nullptr)
+  {
+    return false;
+  }
+  // negative while the driver hasn't made it an output yet
+  int level = gpio_emul_output_get(cfg->rst_gpio.port, cfg->rst_gpio.pin);
+  if (level < 0)
+  {
+    return false;
+  }
+  return (cfg->rst_gpio.dt_flags & GPIO_ACTIVE_LOW) ? level == 0 : level == 1;
+}
+
+// Adds the time since the last call to the power state stats. The reset line is only looked at
+// here, it is taken to have been where it is now for the whole stretch.
+static void cst816s_emul_account(cst816s_emul_data_t *data)
+{
+  const auto *cfg = (const cst816s_emul_cfg_t *)data->target->cfg;
+  auto now = k_uptime_get();
+  auto from = data->accounted_ms;
+  data->accounted_ms = now;
+
+  if (cst816s_emul_in_reset(cfg))
+  {
+    data->stats.reset_ms += uint32_t(now - from);
+    // the registers are back at their defaults and the chip starts awake
+    cst816s_emul_reset_regs(data);
+    data->sample_pending = false;
+    data->activity_ms = now;
+    return;
+  }
+
+  auto active_until = now;
+  if (!data->regs[DISAutoSleep])
+  {
+    active_until = std::clamp<int64_t>(data->activity_ms + data->regs[AutoSleepTime] * MSEC_PER_SEC, from, now);
+  }
+  data->stats.active_ms += uint32_t(active_until - from);
+  data->stats.standby_ms += uint32_t(now - active_until);
+}
+
+static bool cst816s_emul_in_standby(const cst816s_emul_data_t *data)
+{
+  return !data->regs[DISAutoSleep] &&
+         data->accounted_ms >= data->activity_ms + data->regs[AutoSleepTime] * MSEC_PER_SEC;
+}
+
+static void cst816s_emul_read_touch(cst816s_emul_data_t *data)
+{
+  data->stats.reads++;
+  if (!data->sample_pending)
+  {
+    return;
+  }
+  data->sample_pending = false;
+  auto us = uint32_t(k_cyc_to_us_floor64(k_cycle_get_32() - data->irq_cycles));
+  data->stats.latency_sum_us += us;
+  data->stats.latency_max_us = std::max(data->stats.latency_max_us, us);
+}
+
+static int cst816s_emul_transfer(const emul *target, i2c_msg *msgs, int num_msgs, int addr)
+{
+  auto *data = (cst816s_emul_data_t *)target->data;
+
+  cst816s_emul_account(data);
+  // a chip held in reset doesn't acknowledge its address
+  if (cst816s_emul_in_reset((const cst816s_emul_cfg_t *)target->cfg))
+  {
+    data->stats.nacked++;
+    return -EIO;
+  }
+  data->activity_ms = data->accounted_ms;
+  for (int i = 0; i < num_msgs; ++i)
+  {
+    auto &msg = msgs[i];
+    if ((msg.flags & I2C_MSG_RW_MASK) == I2C_MSG_READ)
+    {
+      if (data->reg_ptr == GestureID)
+      {
+        cst816s_emul_read_touch(data);
+      }
+      for (size_t b = 0; b < msg.len; ++b)
+      {
+        msg.buf[b] = data->regs[data->reg_ptr++];
+      }
+    }
+    else if (msg.len > 0)
+    {
+      // the first byte written is the register address, anything after it is register data
+      data->reg_ptr = msg.buf[0];
+      for (size_t b = 1; b < msg.len; ++b)
+      {
+        data->written.set(data->reg_ptr);
+        data->regs[data->reg_ptr++] = msg.buf[b];
+      }
+    }
+  }
+  return 0;
+}
+
+static void cst816s_emul_irq(const cst816s_emul_cfg_t *cfg)
+{
+  // irq-gpios is active low, the driver triggers on the edge to active
+  gpio_emul_input_set(cfg->int_gpio.port, cfg->int_gpio.pin, 0);
+  k_busy_wait(CST816S_EMUL_IRQ_PULSE_US);
+  gpio_emul_input_set(cfg->int_gpio.port, cfg->int_gpio.pin, 1);
+}
+
+// Latches sample into the data registers and pulses the interrupt, waking the chip if needed.
+static void cst816s_emul_touch(cst816s_emul_data_t *data, const cst816s_emul_cfg_t *cfg,
+                               const cst816s_emul_sample_t &sample)
+{
+  if (cst816s_emul_in_standby(data))
+  {
+    data->stats.wakes++;
+  }
+  data->activity_ms = data->accounted_ms;
+
+  if (data->sample_pending)
+  {
+    data->stats.missed++;
+  }
+  data->regs[GestureID] = sample.gesture;
+  data->regs[FingerNum] = sample.event == 0x01 ? 0 : 1;
+  data->regs[XPosH] = uint8_t(sample.event << CST816S_EMUL_EVENT_BITS_POS | ((sample.x >> 8) & 0x0F));
+  data->regs[XPosL] = uint8_t(sample.x);
+  data->regs[YPosH] = uint8_t((sample.y >> 8) & 0x0F);
+  data->regs[YPosL] = uint8_t(sample.y);
+  data->sample_pending = true;
+  data->stats.samples++;
+
+  data->irq_cycles = k_cycle_get_32();
+  cst816s_emul_irq(cfg);
+}
+
+static void cst816s_emul_play_work_handler(k_work *work)
+{
+  auto *data = CONTAINER_OF(k_work_delayable_from_work(work), cst816s_emul_data_t, play_work);
+  const auto *cfg = (const cst816s_emul_cfg_t *)data->target->cfg;
+
+  if (data->trace_pos >= data->trace_len)
+  {
+    return;
+  }
+  const auto &sample = data->trace[data->trace_pos++];
+
+  // the low power scan picks the touch up and the chip wakes with it
+  cst816s_emul_account(data);
+  if (cst816s_emul_in_reset(cfg))
+  {
+    // nothing scans while in reset, the touch is lost without an interrupt
+    data->stats.lost++;
+  }
+  else
+  {
+    cst816s_emul_touch(data, cfg, sample);
+  }
+
+  if (data->trace_pos < data->trace_len)
+  {
+    k_work_schedule(&data->play_work, K_MSEC(data->trace[data->trace_pos].delay_ms));
+  }
+}
+
+int cst816s_emul_play(const emul *target, const cst816s_emul_sample_t *trace, size_t count)
+{
+  const auto *cfg = (const cst816s_emul_cfg_t *)target->cfg;
+  auto *data = (cst816s_emul_data_t *)target->data;
+
+  k_work_cancel_delayable(&data->play_work);
+  // idle level, the driver has configured the pin as an input by now
+  gpio_emul_input_set(cfg->int_gpio.port, cfg->int_gpio.pin, 1);
+  data->trace = trace;
+  data->trace_len = count;
+  data->trace_pos = 0;
+  if (count == 0)
+  {
+    return 0;
+  }
+  return k_work_schedule(&data->play_work, K_MSEC(trace[0].delay_ms)) < 0 ? -EIO : 0;
+}
+
+bool cst816s_emul_playing(const emul *target)
+{
+  auto *data = (cst816s_emul_data_t *)target->data;
+  return data->trace_pos < data->trace_len || k_work_delayable_is_pending(&data->play_work);
+}
+
+int cst816s_emul_reg_written(const emul *target, uint8_t reg)
+{
+  auto *data = (cst816s_emul_data_t *)target->data;
+  cst816s_emul_account(data);
+  return data->written.test(reg) ? data->regs[reg] : -ENODATA;
+}
+
+void cst816s_emul_get_stats(const emul *target, cst816s_emul_stats_t *stats)
+{
+  auto *data = (cst816s_emul_data_t *)target->data;
+  cst816s_emul_account(data);
+  *stats = data->stats;
+}
+
+void cst816s_emul_reset_stats(const emul *target)
+{
+  auto *data = (cst816s_emul_data_t *)target->data;
+  cst816s_emul_account(data);
+  data->stats = {};
+}
+
+static int cst816s_emul_init(const emul *target, const device *parent)
+{
+  auto *data = (cst816s_emul_data_t *)target->data;
+
+  data->target = target;
+  cst816s_emul_reset_regs(data);
+  data->accounted_ms = k_uptime_get();
+  data->activity_ms = data->accounted_ms;
+  k_work_init_delayable(&data->play_work, cst816s_emul_play_work_handler);
+  LOG_DBG("CST816S emulator on %s", parent->name);
+  return 0;
+}
+
+static i2c_emul_api cst816s_emul_api = {
+    .transfer = cst816s_emul_transfer,
+};
+
+#define CST816S_EMUL_DEFINE(index)                                                               \
+  static cst816s_emul_data_t cst816s_emul_data_##index;                                          \
+  static const cst816s_emul_cfg_t cst816s_emul_cfg_##index = {                                   \
+      .int_gpio = GPIO_DT_SPEC_INST_GET(index, irq_gpios),                                       \
+      .rst_gpio = GPIO_DT_SPEC_INST_GET_OR(index, rst_gpios, {}),                                \
+  };                                                                                             \
+  EMUL_DT_INST_DEFINE(index, cst816s_emul_init, &cst816s_emul_data_##index,                      \
+                      &cst816s_emul_cfg_##index, &cst816s_emul_api, nullptr);
+
+DT_INST_FOREACH_STATUS_OKAY(CST816S_EMUL_DEFINE)
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <zephyr/drivers/emul.h>
+
+#include <cstddef>
+#include <cstdint>
+
+// I2C emulator of the CST816S for native_sim. It replays scripted touch traces through the data
+// registers and the interrupt line and measures how long the driver takes to read each sample.
+// While the reset line is held the chip doesn't answer on the bus and touches are lost.
+
+struct cst816s_emul_sample_t
+{
+  uint32_t delay_ms; // after the previous sample
+  uint16_t x;
+  uint16_t y;
+  uint8_t event;     // PressDown, LiftUp or Contact as in the driver
+  uint8_t gesture;
+};
+
+struct cst816s_emul_stats_t
+{
+  uint32_t samples;    // samples played
+  uint32_t reads;      // burst reads of the touch data
+  uint32_t missed;     // samples overwritten before the driver read them
+  uint32_t latency_max_us;
+  uint64_t latency_sum_us; // from the interrupt edge to the read of the sample
+  // time spent in each power state, the chip drops to the low power scan after AutoSleepTime
+  // seconds without a touch or bus access
+  uint32_t active_ms;
+  uint32_t standby_ms;
+  uint32_t reset_ms;
+  uint32_t wakes;  // samples that woke the chip from the low power scan
+  uint32_t lost;   // samples played while the chip was held in reset, no interrupt for them
+  uint32_t nacked; // transfers while the chip was held in reset
+};
+
+// Starts replaying trace, which has to stay valid until it is done. A running trace is replaced.
+int cst816s_emul_play(const emul *target, const cst816s_emul_sample_t *trace, size_t count);
+bool cst816s_emul_playing(const emul *target);
+
+// Returns the value of reg if the driver wrote it since the chip last left reset, -ENODATA if not.
+int cst816s_emul_reg_written(const emul *target, uint8_t reg);
+
+void cst816s_emul_get_stats(const emul *target, cst816s_emul_stats_t *stats);
+void cst816s_emul_reset_stats(const emul *target);
@@ -1,5 +1,9 @@
+#ifdef CONFIG_BT
 #include "managers/bluetooth.hpp"
+#endif
+#ifdef CONFIG_DK_LIBRARY
 #include "managers/devkit.hpp"
+#endif
 #include "managers/display.hpp"
 
 #include <zephyr/kernel.h>
@@ -7,14 +11,17 @@
 
 LOG_MODULE_REGISTER(nrf_test, CONFIG_NRF_TEST_LOG_LEVEL);
 
-using managers::bt::Bluetooth;
-using managers::devkit::DevKit;
 using managers::display::Display;
 
 void run_init(k_work *item)
 {
-  DevKit::instance().init();
-  Bluetooth::instance().init();
+  // native_sim builds have neither the devkit nor bluetooth
+#ifdef CONFIG_DK_LIBRARY
+  managers::devkit::DevKit::instance().init();
+#endif
+#ifdef CONFIG_BT
+  managers::bt::Bluetooth::instance().init();
+#endif
   Display::instance().init();
 }
 K_WORK_DEFINE(init_work, run_init);
@@ -22,7 +29,11 @@ K_WORK_DEFINE(init_work, run_init);
 int main()
 {
   LOG_INF("Git hash: %s", GIT_HASH);
+#ifdef CONFIG_HAS_NRFX
   LOG_INF("Starting %s with CPU frequency: %d MHz", CONFIG_BOARD, SystemCoreClock / MHZ(1));
+#else
+  LOG_INF("Starting %s", CONFIG_BOARD);
+#endif
   k_work_submit(&init_work);
   return 0;
 }
\ No newline at end of file
@@ -3,11 +3,10 @@
 #include "ble/bt.hpp"
 #include "ble/auth.hpp"
 #include "ble/services/gadgetbridge.hpp"
+#include "managers/display.hpp"
 
 #include <zephyr/logging/log.h>
 
-#include "ui/ui.h"
-
 using namespace managers::bt;
 
 LOG_MODULE_REGISTER(nrf_test_bt, CONFIG_NRF_TEST_LOG_LEVEL);
@@ -57,10 +56,10 @@ void Bluetooth::passkey_display_cb(unsigned int passkey)
 
 void Bluetooth::connected_cb()
 {
-  lv_obj_clear_flag(ui_bluetooth, LV_OBJ_FLAG_HIDDEN);
+  managers::display::Display::instance().post({managers::display::Message::BluetoothConnected});
 }
 
 void Bluetooth::disconnected_cb()
 {
-  lv_obj_add_flag(ui_bluetooth, LV_OBJ_FLAG_HIDDEN);
+  managers::display::Display::instance().post({managers::display::Message::BluetoothDisconnected});
 }
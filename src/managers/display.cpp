@@ -1,5 +1,9 @@
 #include "managers/display.hpp"
 
+#include "drivers/display/color.hpp"
+#include "drivers/display/gc9a01.hpp"
+#include "drivers/input/cst816s.hpp"
+#include "perf/profiler.hpp"
 #include "ui/ui.h"
 
 #include <zephyr/kernel.h>
@@ -8,10 +12,13 @@
 #include <zephyr/pm/device.h>
 #include <zephyr/drivers/pwm.h>
 #include <zephyr/drivers/display.h>
+#include <zephyr/input/input.h>
+#include <zephyr/posix/time.h>
 
 #include <algorithm>
 #include <array>
 #include <chrono>
+#include <cstring>
 
 #include <lvgl.h>
 
@@ -19,6 +26,46 @@ using namespace managers::display;
 
 LOG_MODULE_REGISTER(nrf_test_display, CONFIG_NRF_TEST_LOG_LEVEL);
 
+K_THREAD_STACK_DEFINE(display_stack, CONFIG_NRF_TEST_DISPLAY_THREAD_STACK_SIZE);
+
+// screens marked with reduce_color
+constexpr auto LV_OBJ_FLAG_COLOR_12_BIT = LV_OBJ_FLAG_USER_1;
+
+// Runs a pm action of the panel or touch controller, one that is already in the target state is fine.
+static int run_pm_action(const device *dev, pm_device_action action)
+{
+  if (dev == nullptr)
+  {
+    return -ENODEV;
+  }
+  int err = pm_device_action_run(dev, action);
+  if (err == -EALREADY)
+  {
+    return 0;
+  }
+  if (err < 0)
+  {
+    LOG_ERR("%s: pm action %d failed (err %d)", dev->name, action, err);
+  }
+  return err;
+}
+
+static void touch_input_cb(input_event *evt)
+{
+  auto &display = Display::instance();
+  display.touch_activity(evt->sync);
+
+  if (IS_ENABLED(CONFIG_NRF_TEST_TOUCH_GESTURES) && evt->type == INPUT_EV_KEY)
+  {
+    auto gesture = ui::Navigation::from_input(evt->code);
+    if (gesture != ui::Gesture::None)
+    {
+      display.post({Message::TouchGesture, gesture});
+    }
+  }
+}
+INPUT_CALLBACK_DEFINE(DEVICE_DT_GET_OR_NULL(DT_NODELABEL(cst816s)), touch_input_cb);
+
 Display &Display::instance()
 {
   static const struct pwm_dt_spec display_bkl = PWM_DT_SPEC_GET_OR(DT_ALIAS(display_bkl), {});
@@ -72,8 +119,14 @@ Display::Display(const device *display, const device *touch, const device *count
   _brightness_alarm_stop.callback = &brightness_alarm_stop_cb;
   _brightness_alarm_stop.user_data = (void *)this;
 
-  _brightness_alarm_start.ticks = counter_us_to_ticks(_counter, 0);
-  _brightness_alarm_run.ticks = counter_us_to_ticks(_counter, 750);
+  k_sem_init(&_flush_sem, 0, 1);
+  k_msgq_init(&_msgq, _msgq_buf, sizeof(Message), CONFIG_NRF_TEST_DISPLAY_MSGQ_SIZE);
+
+  if (has_backlight())
+  {
+    _brightness_alarm_start.ticks = counter_us_to_ticks(_counter, 0);
+    _brightness_alarm_run.ticks = counter_us_to_ticks(_counter, 750);
+  }
   k_sem_take(nullptr, K_NO_WAIT);
 }
 
@@ -83,7 +136,11 @@ void Display::init()
   {
     LOG_ERR("Display device not ready");
   }
-  if (!device_is_ready(_backlight.dev))
+  if (!has_backlight())
+  {
+    LOG_WRN("No backlight, brightness is ignored");
+  }
+  else if (!device_is_ready(_backlight.dev))
   {
     LOG_ERR("Backlight device not ready");
   }
@@ -91,6 +148,25 @@ void Display::init()
   {
     LOG_ERR("Touch device not ready");
   }
+  else if (IS_ENABLED(CONFIG_INPUT_CST816S_WAKE))
+  {
+    cst816s_set_wake_callback(_touch, touch_wake_cb, this);
+  }
+
+  perf::init();
+
+  k_work_queue_init(&_work_q);
+  k_work_queue_start(&_work_q, display_stack, K_THREAD_STACK_SIZEOF(display_stack),
+                     CONFIG_NRF_TEST_DISPLAY_THREAD_PRIORITY, nullptr);
+  k_thread_name_set(&_work_q.thread, "display");
+
+  // everything touching lvgl from here on runs on the display thread
+  k_work_submit_to_queue(&_work_q, &_init_work);
+}
+
+void Display::do_init(k_work *work)
+{
+  auto &display = Display::instance();
 
   lv_indev_t *touch_indev = lv_indev_get_next(NULL);
   while (touch_indev)
@@ -106,44 +182,273 @@ void Display::init()
     touch_indev = lv_indev_get_next(touch_indev);
   }
 
-  pwm_set_pulse_dt(&_backlight, 0); // reset the backlight
+  // the pointer is only polled while the touch controller reports activity, see touch_activity
+  display._touch_indev = touch_indev;
+  if (display._touch_indev != nullptr)
+  {
+    lv_timer_pause(display._touch_indev->driver->read_timer);
+    if (IS_ENABLED(CONFIG_NRF_TEST_TOUCH_FILTER))
+    {
+      display._touch_filter.attach(display._touch_indev);
+    }
+    if (IS_ENABLED(CONFIG_NRF_TEST_TOUCH_GESTURES))
+    {
+      display._navigation.attach(display._touch_indev);
+    }
+  }
+
+  // pipeline flushes: the pixel data of a band is sent while lvgl renders the next one into the other vdb
+  lv_disp_t *disp = lv_disp_get_default();
+  disp->driver->flush_cb = flush_cb;
+  disp->driver->wait_cb = flush_wait_cb;
+  if (IS_ENABLED(CONFIG_NRF_TEST_DISPLAY_SOLID_FILL))
+  {
+    display._solid_fill.attach(disp);
+  }
+  if (IS_ENABLED(CONFIG_NRF_TEST_DISPLAY_ROUND))
+  {
+    display._round_mask.attach(disp);
+  }
+  if (IS_ENABLED(CONFIG_NRF_TEST_DISPLAY_HW_SCROLL))
+  {
+    display._hw_scroll.attach(disp, display._display, &display._flush_filter);
+  }
+  if (IS_ENABLED(CONFIG_NRF_TEST_DISPLAY_ADAPTIVE_VDB))
+  {
+    display._draw_buffers.attach(disp);
+  }
+
+  if (display.has_backlight())
+  {
+    pwm_set_pulse_dt(&display._backlight, 0); // reset the backlight
+  }
   ui_init();
-  on();
+  // the stopwatch redraws its milliseconds every frame
+  display.reduce_color(ui_stopwatch, true);
+  display.on();
 }
 
 void Display::on()
 {
-  if (_state == Display::On)
-    return;
-
   _state = Display::On;
+  k_work_reschedule_for_queue(&_work_q, &_power_work, K_NO_WAIT);
+}
 
-  pm_device_action_run(_display, PM_DEVICE_ACTION_RESUME);
-  pm_device_action_run(_touch, PM_DEVICE_ACTION_RESUME);
-
-  set_brightness(_last_brightness);
-  display_blanking_off(_display);
-  k_work_schedule(&_render_work, K_MSEC(lv_task_handler()));
+void Display::ambient()
+{
+  _state = Display::Ambient;
+  k_work_reschedule_for_queue(&_work_q, &_power_work, K_NO_WAIT);
 }
 
 void Display::sleep()
 {
-  if (_state == Display::Sleep)
+  _state = Display::Sleep;
+  k_work_reschedule_for_queue(&_work_q, &_power_work, K_NO_WAIT);
+}
+
+// Runs on the display thread, so it never overlaps a refresh. Calls that came in while it was queued
+// collapse into one transition to the last requested state. Nothing in it sleeps, a transition that
+// has to wait for the panel to settle is retried once it has.
+void Display::power(k_work *work)
+{
+  auto *display = CONTAINER_OF(k_work_delayable_from_work(work), Display, _power_work);
+  auto from = display->_powered;
+  auto to = display->_state;
+  if (from == to)
     return;
 
-  _state = Display::Sleep;
-  k_work_cancel_delayable_sync(&_render_work, &_render_cancel_sync);
-  k_msleep(CONFIG_LV_DISP_DEF_REFR_PERIOD * 2);
+  if (from == Display::Sleep || to == Display::Sleep)
+  {
+    auto wait = display->panel_toggle_in(to == Display::Sleep ? PM_DEVICE_ACTION_SUSPEND : PM_DEVICE_ACTION_RESUME);
+    if (wait > 0)
+    {
+      k_work_reschedule_for_queue(&display->_work_q, &display->_power_work, K_MSEC(wait));
+      return;
+    }
+  }
 
-  display_blanking_on(_display);
-  pm_device_action_run(_display, PM_DEVICE_ACTION_SUSPEND);
-  pm_device_action_run(_touch, PM_DEVICE_ACTION_SUSPEND);
-  _last_brightness = _brightness;
-  set_brightness(0);
+  if (from == Display::On && !display->_waking)
+  {
+    display->_last_brightness = display->_brightness;
+  }
+  display->_powered = to;
 
+  if (to == Display::Sleep)
+  {
+    display->power_down();
+  }
+  else
+  {
+    display->power_up(from);
+  }
+}
+
+int32_t Display::panel_toggle_in(pm_device_action action) const
+{
+  // an action the panel is already in doesn't run and needn't wait, like the resume after boot
+  pm_device_state state;
+  if (pm_device_state_get(_display, &state) < 0)
+  {
+    return 0;
+  }
+  bool runs = action == PM_DEVICE_ACTION_SUSPEND ? state == PM_DEVICE_STATE_ACTIVE
+                                                 : state == PM_DEVICE_STATE_SUSPENDED;
+  return runs ? gc9a01_sleep_toggle_in(_display) : 0;
+}
+
+void Display::touch_wake_cb(const device *dev, void *user_data)
+{
+  auto *display = (Display *)user_data;
+  // the wake is timed from the touch, power_up doesn't start it again
+  if (display->_powered == Display::Sleep && atomic_cas(&display->_touch_woke, 0, 1))
+  {
+    perf::wake_begin();
+  }
+  display->on();
+}
+
+void Display::power_up(State from)
+{
+  bool touch_woke = atomic_cas(&_touch_woke, 1, 0);
+  if (from == Display::Sleep)
+  {
+    // only SLPOUT, the panel settles while the first frame renders and is switched on once it is out
+    if (!touch_woke)
+    {
+      perf::wake_begin();
+    }
+    run_pm_action(_display, PM_DEVICE_ACTION_RESUME);
+    _waking = true;
+  }
+
+  // the touch controller comes back from its low power scan right away, after a reset it boots in the
+  // background and reports once it is configured
+  if (_powered == Display::On)
+  {
+    run_pm_action(_touch, PM_DEVICE_ACTION_RESUME);
+  }
+  else
+  {
+    run_pm_action(_touch, PM_DEVICE_ACTION_SUSPEND);
+    gc9a01_on_next_te(_display, nullptr, nullptr);
+  }
+
+  if (!_waking)
+  {
+    set_brightness(lit_brightness());
+  }
+  k_work_reschedule_for_queue(&_work_q, &_render_work, K_NO_WAIT);
+}
+
+uint8_t Display::lit_brightness() const
+{
+  return _powered == Display::Ambient ? CONFIG_NRF_TEST_DISPLAY_AMBIENT_BRIGHTNESS : _last_brightness;
+}
+
+void Display::enter_ambient()
+{
+  _ambient_active = true;
+  if (lv_scr_act() != ui_watchface)
+  {
+    lv_scr_load(ui_watchface);
+  }
+  _time_model.show_seconds(false);
+  _time_model.update(std::time(nullptr));
+  lv_obj_update_layout(ui_timehhmmss);
+
+  // the panel drives whole gate lines, the band spans the label along them
+  lv_area_t band;
+  lv_obj_get_coords(ui_timehhmmss, &band);
+  bool on_x = gc9a01_scroll_axis(_display) == GC9A01_SCROLL_X;
+  lv_coord_t start = std::max<lv_coord_t>(on_x ? band.x1 : band.y1, 0);
+  lv_coord_t end = std::min<lv_coord_t>(on_x ? band.x2 : band.y2, (on_x ? lv_disp_get_hor_res(nullptr) : lv_disp_get_ver_res(nullptr)) - 1);
+  _ambient_band = on_x ? lv_area_t{start, 0, end, lv_coord_t(lv_disp_get_ver_res(nullptr) - 1)}
+                       : lv_area_t{0, start, lv_coord_t(lv_disp_get_hor_res(nullptr) - 1), end};
+
+  int err = gc9a01_ambient_on(_display, start, end);
+  if (err)
+  {
+    LOG_ERR("Failed to enter ambient mode (err %d)", err);
+  }
+}
+
+void Display::exit_ambient()
+{
+  _ambient_active = false;
+  int err = gc9a01_ambient_off(_display);
+  if (err)
+  {
+    LOG_ERR("Failed to leave ambient mode (err %d)", err);
+  }
+  _time_model.show_seconds(true);
+  // flushes outside of the band were dropped, the flush filter skips whatever is still on the panel
   lv_obj_invalidate(lv_scr_act());
 }
 
+void Display::power_down()
+{
+  // dark first, the rest of the way down isn't visible
+  set_brightness(0);
+  _waking = false;
+  gc9a01_on_next_te(_display, nullptr, nullptr);
+  // no refresh is running on this thread, only the last band of one may still be on the bus
+  k_work_cancel_delayable(&_render_work);
+  gc9a01_write_wait(_display);
+
+  display_blanking_on(_display);
+  run_pm_action(_display, PM_DEVICE_ACTION_SUSPEND);
+  run_pm_action(_touch, PM_DEVICE_ACTION_SUSPEND);
+
+  gc9a01_bus_stats_t stats;
+  gc9a01_get_bus_stats(_display, &stats);
+  LOG_DBG("SPI bus: %u references, %u resumes, %u suspends, %u resumes saved",
+          stats.gets, stats.resumes, stats.suspends, stats.gets - stats.resumes);
+  LOG_DBG("CPU idle %u%%", _cpu_idle);
+  const auto &label_stats = _time_model.stats();
+  LOG_DBG("Labels: %u set, %u unchanged, %llu px invalidated",
+          label_stats.sets, label_stats.skips, label_stats.dirty_px);
+  const auto &fill_stats = _solid_fill.stats();
+  LOG_DBG("Solid fills: %u sent, %u rendered after all", fill_stats.fills, fill_stats.materialized);
+  const auto &mask_stats = _round_mask.stats();
+  LOG_DBG("Round mask: %u areas, %u splits, %llu px skipped",
+          mask_stats.areas, mask_stats.splits, mask_stats.saved_px);
+  const auto &vdb_stats = _draw_buffers.stats();
+  LOG_DBG("Draw buffers: mode %u, %u switches, %u failed allocations, %u px per refresh",
+          _draw_buffers.mode(), vdb_stats.switches, vdb_stats.alloc_fails, vdb_stats.avg_px);
+  const auto &scroll_stats = _hw_scroll.stats();
+  LOG_DBG("Hardware scroll: %u steps, %u redrawn, %llu px moved on the panel",
+          scroll_stats.scrolls, scroll_stats.redraws, scroll_stats.saved_px);
+  const auto &filter_stats = _flush_filter.stats();
+  LOG_DBG("Flush filter: %u skipped, %u sent, %llu bytes saved",
+          filter_stats.hits, filter_stats.misses, filter_stats.skipped_bytes);
+  if (_touch != nullptr)
+  {
+    cst816s_stats_t touch_stats;
+    cst816s_get_stats(_touch, &touch_stats);
+    LOG_DBG("Touch: %u samples, %u read from the interrupt, %u errors, %u events dropped, latency avg %uus max %uus",
+            touch_stats.samples, touch_stats.async_reads, touch_stats.errors, touch_stats.dropped,
+            touch_stats.samples ? uint32_t(touch_stats.latency_sum_us / touch_stats.samples) : 0,
+            touch_stats.latency_max_us);
+    LOG_DBG("Touch: %u warm resumes, %u resets", touch_stats.warm_resumes, touch_stats.resets);
+  }
+  const auto touch_filter_stats = _touch_filter.stats();
+  LOG_DBG("Touch filter: %u samples, %u coalesced, %u dropped, %u predicted",
+          touch_filter_stats.samples, touch_filter_stats.coalesced, touch_filter_stats.dropped,
+          touch_filter_stats.predicted);
+  const auto &nav_stats = _navigation.stats();
+  LOG_DBG("Navigation: %u gestures, %u screen switches, %u left to widgets",
+          nav_stats.gestures, nav_stats.switches, nav_stats.ignored);
+  perf::log();
+
+  // GRAM survives SLPIN, so the panel wakes up with the last frame and only what changed while
+  // asleep, usually the time, is redrawn. Otherwise everything is sent again.
+  if (!IS_ENABLED(CONFIG_NRF_TEST_DISPLAY_FAST_WAKE))
+  {
+    _flush_filter.reset();
+    lv_obj_invalidate(lv_scr_act());
+  }
+}
+
 void Display::set_brightness(uint8_t brightness)
 {
   _brightness = std::min(brightness, uint8_t(32));
@@ -154,6 +459,8 @@ void Display::set_brightness(uint8_t brightness)
 void Display::do_set_brightness(k_work *work)
 {
   auto *display = CONTAINER_OF(work, Display, _brightness_work);
+  if (!display->has_backlight())
+    return;
 
   auto npulses = 32 - display->_brightness;
 
@@ -171,22 +478,366 @@ uint8_t Display::get_brightness()
   return _brightness;
 }
 
+void Display::request_render()
+{
+  if (_state == Display::Sleep)
+    return;
+
+  k_work_reschedule_for_queue(&_work_q, &_render_work, K_NO_WAIT);
+}
+
+int Display::post(const Message &msg)
+{
+  int err = k_msgq_put(&_msgq, &msg, K_NO_WAIT);
+  if (err)
+  {
+    LOG_WRN("Display message queue full, dropped message %u", msg.type);
+    return err;
+  }
+  // messages posted while asleep are handled on the first render after waking
+  request_render();
+  return 0;
+}
+
+void Display::handle(const Message &msg)
+{
+  switch (msg.type)
+  {
+  case Message::BluetoothConnected:
+    lv_obj_clear_flag(ui_bluetooth, LV_OBJ_FLAG_HIDDEN);
+    break;
+  case Message::BluetoothDisconnected:
+    lv_obj_add_flag(ui_bluetooth, LV_OBJ_FLAG_HIDDEN);
+    break;
+  case Message::TouchGesture:
+    _navigation.dispatch(msg.gesture);
+    break;
+  }
+}
+
+void Display::touch_activity(bool sync)
+{
+  if (sync)
+  {
+    _touch_filter.queued();
+  }
+  atomic_set(&_touch_pending, 1);
+  request_render();
+}
+
+uint8_t Display::cpu_idle()
+{
+  return _cpu_idle;
+}
+
+int Display::scroll_with_panel(lv_obj_t *obj)
+{
+  if (!IS_ENABLED(CONFIG_NRF_TEST_DISPLAY_HW_SCROLL))
+    return -ENOTSUP;
+
+  if (obj == nullptr)
+  {
+    _hw_scroll.unbind();
+    return 0;
+  }
+  int err = _hw_scroll.bind(obj);
+  if (err)
+  {
+    LOG_WRN("Can't scroll with the panel (err %d)", err);
+  }
+  return err;
+}
+
+void Display::reduce_color(lv_obj_t *screen, bool reduce)
+{
+  if (reduce)
+  {
+    lv_obj_add_flag(screen, LV_OBJ_FLAG_COLOR_12_BIT);
+  }
+  else
+  {
+    lv_obj_clear_flag(screen, LV_OBJ_FLAG_COLOR_12_BIT);
+  }
+}
+
+void Display::update_color_depth()
+{
+  if (!IS_ENABLED(CONFIG_NRF_TEST_DISPLAY_COLOR_12_BIT))
+    return;
+
+  bool reduce = _ambient_active || lv_obj_has_flag(lv_scr_act(), LV_OBJ_FLAG_COLOR_12_BIT);
+  auto depth = reduce ? GC9A01_COLOR_12_BIT : GC9A01_COLOR_16_BIT;
+  if (depth == gc9a01_color_depth(_display))
+    return;
+
+  int err = gc9a01_set_color_depth(_display, depth);
+  if (err)
+  {
+    LOG_ERR("Failed to set the color depth (err %d)", err);
+    return;
+  }
+  // the remembered hashes are of pixels sent in the other depth
+  _flush_filter.reset();
+  if (depth == GC9A01_COLOR_16_BIT)
+  {
+    // whatever was sent with 12 bits is still on the panel
+    lv_obj_invalidate(lv_scr_act());
+  }
+}
+
+uint32_t Display::schedule_input(uint32_t next)
+{
+  if (_touch_indev == nullptr)
+    return next;
+
+  auto *read_timer = _touch_indev->driver->read_timer;
+  auto now = k_uptime_get();
+  if (atomic_cas(&_touch_pending, 1, 0))
+  {
+    _touch_last = now;
+    lv_timer_resume(read_timer);
+    lv_timer_ready(read_timer);
+    return 0;
+  }
+
+  // keep polling for a couple of periods after the last event so lvgl sees the release
+  if (!read_timer->paused &&
+      _touch_indev->proc.state == LV_INDEV_STATE_RELEASED &&
+      now - _touch_last > 2 * CONFIG_LV_INDEV_DEF_READ_PERIOD)
+  {
+    lv_timer_pause(read_timer);
+  }
+  return next;
+}
+
+uint32_t Display::schedule_refresh(uint32_t next)
+{
+  // lvgl's refresh timer runs every period even when nothing is dirty, only keep it while there is work
+  lv_disp_t *disp = lv_disp_get_default();
+  if (disp->inv_p > 0)
+  {
+    lv_timer_resume(disp->refr_timer);
+    return std::min<uint32_t>(next, CONFIG_LV_DISP_DEF_REFR_PERIOD);
+  }
+  if (lv_anim_count_running() == 0)
+  {
+    lv_timer_pause(disp->refr_timer);
+  }
+  return next;
+}
+
+void Display::account_busy(uint32_t cycles)
+{
+  _busy_cycles += cycles;
+  uint32_t elapsed = k_cycle_get_32() - _busy_window_start;
+  if (elapsed >= sys_clock_hw_cycles_per_sec())
+  {
+    _cpu_idle = uint8_t(100 - uint64_t(_busy_cycles) * 100 / elapsed);
+    _busy_cycles = 0;
+    _busy_window_start += elapsed;
+  }
+}
+
+void Display::flush_cb(lv_disp_drv_t *disp_drv, const lv_area_t *area, lv_color_t *color_p)
+{
+  auto &display = Display::instance();
+  bool packed = gc9a01_color_depth(display._display) == GC9A01_COLOR_12_BIT;
+
+  // in ambient mode only the band is driven, whatever lies outside of it is sent when leaving
+  if (display._ambient_active && !_lv_area_is_on(area, &display._ambient_band))
+  {
+    lv_disp_flush_ready(disp_drv);
+    return;
+  }
+
+  // a band lvgl only filled with one color is sent from the driver's fill buffer
+  lv_color_t fill;
+  bool solid = display._solid_fill.take(area, &fill);
+
+  // skip bands that were redrawn with the pixels the panel already shows
+  if (IS_ENABLED(CONFIG_NRF_TEST_DISPLAY_FLUSH_FILTER) &&
+      (solid ? display._flush_filter.unchanged(area, fill) : display._flush_filter.unchanged(area, color_p)))
+  {
+    flush_skipped(disp_drv);
+    return;
+  }
+
+  // the rows of the band go out in groups clipped to the round panel, see RoundMask
+  lv_area_t parts[ui::RoundMask::MAX_PARTS];
+  size_t count = 1;
+  parts[0] = *area;
+  if (IS_ENABLED(CONFIG_NRF_TEST_DISPLAY_ROUND) && !display._hw_scroll.scrolls(area))
+  {
+    count = display._round_mask.split(area, parts);
+  }
+  if (count == 0)
+  {
+    flush_skipped(disp_drv);
+    return;
+  }
+
+  // only bands that are sent are timed and counted
+  auto flush_begin = [&]
+  {
+    if (IS_ENABLED(CONFIG_NRF_TEST_PROFILING))
+    {
+      uint32_t px = 0;
+      for (size_t i = 0; i < count; ++i)
+      {
+        px += lv_area_get_size(&parts[i]);
+      }
+      // gc9a01_write_async waits for the previous band anyway, do it here so only this band is timed
+      gc9a01_write_wait(display._display);
+      perf::flush_begin(px, packed ? color::rgb444_size(px) : px * sizeof(lv_color_t));
+    }
+    display._flush_area = *area;
+    display._flush_failed = false;
+  };
+
+  if (solid)
+  {
+#if LV_COLOR_16_SWAP
+    uint16_t color = __bswap_16(fill.full);
+#else
+    uint16_t color = fill.full;
+#endif
+    flush_begin();
+    int err = 0;
+    for (size_t i = 0; i < count && !err; ++i)
+    {
+      err = gc9a01_fill_rect(display._display, parts[i].x1, parts[i].y1,
+                             lv_area_get_width(&parts[i]), lv_area_get_height(&parts[i]), color);
+    }
+    if (err)
+    {
+      LOG_ERR("Failed to fill display (err %d)", err);
+    }
+    flush_done_cb(display._display, err, disp_drv);
+    return;
+  }
+
+  flush_begin();
+  // lvgl doesn't read a band again once it is flushed, so each part is moved together in place right
+  // behind the previous one, and packed there to 12-bit, while the previous one is being sent
+  auto *next = (uint8_t *)color_p;
+  for (size_t i = 0; i < count; ++i)
+  {
+    const auto &part = parts[i];
+    display_buffer_descriptor desc;
+    desc.width = lv_area_get_width(&part);
+    desc.height = lv_area_get_height(&part);
+    desc.pitch = desc.width;
+    desc.buf_size = desc.width * desc.height * sizeof(lv_color_t);
+
+    auto *pixels = (lv_color_t *)next;
+    if (!lv_area_is_equal(&part, area))
+    {
+      const auto *src = color_p + (part.y1 - area->y1) * lv_area_get_width(area) + (part.x1 - area->x1);
+      for (lv_coord_t row = 0; row < desc.height; ++row)
+      {
+        memmove(pixels + row * desc.width, src + row * lv_area_get_width(area), desc.width * sizeof(lv_color_t));
+      }
+    }
+    if (packed)
+    {
+#if LV_COLOR_16_SWAP
+      color::pack_row_444_swapped((const uint16_t *)pixels, (uint8_t *)pixels, desc.width * desc.height);
+#else
+      color::pack_row_444((const uint16_t *)pixels, (uint8_t *)pixels, desc.width * desc.height);
+#endif
+      desc.buf_size = color::rgb444_size(desc.width * desc.height);
+    }
+    // the next part starts aligned for the pixel reads of the packer
+    next += ROUND_UP(desc.buf_size, sizeof(lv_color_t));
+
+    bool last = i == count - 1;
+    int err = gc9a01_write_async(display._display, part.x1, part.y1, &desc, pixels,
+                                 last ? flush_done_cb : flush_part_cb, disp_drv);
+    if (err)
+    {
+      LOG_ERR("Failed to flush display (err %d)", err);
+      // the parts before it may still be reading the band
+      gc9a01_write_wait(display._display);
+      display._flush_filter.forget(area);
+      lv_disp_flush_ready(disp_drv);
+      return;
+    }
+  }
+}
+
+void Display::flush_part_cb(const device *dev, int result, void *user_data)
+{
+  if (result < 0)
+  {
+    Display::instance()._flush_failed = true;
+  }
+}
+
+void Display::flush_done_cb(const device *dev, int result, void *user_data)
+{
+  auto *disp_drv = (lv_disp_drv_t *)user_data;
+  auto &display = Display::instance();
+  // the panel may hold anything in the band now, before lvgl can hand out the next one
+  if (result < 0 || display._flush_failed)
+  {
+    display._flush_filter.forget(&display._flush_area);
+  }
+  perf::flush_end();
+  lv_disp_flush_ready(disp_drv);
+  k_sem_give(&display._flush_sem);
+}
+
+void Display::flush_skipped(lv_disp_drv_t *disp_drv)
+{
+  perf::flush_skip();
+  lv_disp_flush_ready(disp_drv);
+  k_sem_give(&Display::instance()._flush_sem);
+}
+
+void Display::flush_wait_cb(lv_disp_drv_t *disp_drv)
+{
+  // lvgl calls this in a loop until the flushing flag is cleared, so a stale give is harmless
+  k_sem_take(&Display::instance()._flush_sem, K_FOREVER);
+}
+
 extern std::chrono::time_point<std::chrono::high_resolution_clock> stopwatch_start_time;
 extern bool stopwatch_started;
 
 void Display::render(k_work *work)
 {
-  std::array<char, 25> time_buf{0};
-  auto now = std::time(nullptr);
+  auto *display = CONTAINER_OF(k_work_delayable_from_work(work), Display, _render_work);
+  // a TE callback or request_render that raced with going to sleep
+  if (display->_powered == Display::Sleep)
+    return;
+
+  // right after SLPOUT the panel takes no commands for a few ms, come back then instead of waiting for
+  // it in the first flush
+  if (auto wait = gc9a01_cmd_ready_in(display->_display); wait > 0)
+  {
+    k_work_reschedule_for_queue(&display->_work_q, &display->_render_work, K_MSEC(wait));
+    return;
+  }
 
-  std::strftime(time_buf.data(), time_buf.size(), "%a %b %d", std::localtime(&now));
-  lv_label_set_text(ui_daymonth, time_buf.data());
+  auto start = k_cycle_get_32();
+  perf::loop_begin();
 
-  std::strftime(time_buf.data(), time_buf.size(), "%T", std::localtime(&now));
-  lv_label_set_text(ui_timehhmmss, time_buf.data());
+  if (display->_powered == Display::Ambient && !display->_ambient_active)
+  {
+    display->enter_ambient();
+  }
+  else if (display->_powered == Display::On && display->_ambient_active)
+  {
+    display->exit_ambient();
+  }
+  display->update_color_depth();
+
+  Message msg;
+  while (k_msgq_get(&display->_msgq, &msg, K_NO_WAIT) == 0)
+  {
+    display->handle(msg);
+  }
 
-  std::strftime(time_buf.data(), time_buf.size(), "%Y", std::localtime(&now));
-  lv_label_set_text(ui_year, time_buf.data());
+  display->_time_model.update(std::time(nullptr));
 
   if (stopwatch_started)
   {
@@ -199,10 +850,72 @@ void Display::render(k_work *work)
              minutes.count(),
              seconds.count(),
              milliseconds.count());
-    lv_label_set_text(ui_time, time_buf.data());
+    display->_time_model.update_stopwatch(time_buf.data());
+  }
+
+  display->schedule_input(0);
+
+  // keep the spi bus resumed across every band of the refresh
+  gc9a01_frame_begin(display->_display);
+  perf::render_begin();
+  uint32_t next = lv_task_handler();
+  perf::render_end();
+
+  // resize the draw buffers between refreshes, once the last band is out of the old ones
+  if (IS_ENABLED(CONFIG_NRF_TEST_DISPLAY_ADAPTIVE_VDB) && display->_draw_buffers.update())
+  {
+    gc9a01_write_wait(display->_display);
+    display->_draw_buffers.apply();
+  }
+  gc9a01_frame_end(display->_display);
+
+  // the first frame after waking is on the panel, show it
+  if (display->_waking && lv_disp_get_default()->inv_p == 0)
+  {
+    gc9a01_write_wait(display->_display);
+    display_blanking_off(display->_display);
+    display->set_brightness(display->lit_brightness());
+    display->_waking = false;
+    perf::wake_end();
   }
 
-  k_work_delayable *_render_work = CONTAINER_OF(work, k_work_delayable, work);
-  lv_task_handler();
-  k_work_schedule(_render_work, K_NO_WAIT);
+  next = display->schedule_input(next);
+  next = display->schedule_refresh(next);
+
+  // sleep until the next lvgl timer, the next second for the watchface or a request_render
+  timespec now_ts;
+  clock_gettime(CLOCK_REALTIME, &now_ts);
+  next = std::min<uint32_t>(next, MSEC_PER_SEC - now_ts.tv_nsec / NSEC_PER_MSEC);
+  if (stopwatch_started)
+  {
+    next = std::min<uint32_t>(next, CONFIG_LV_DISP_DEF_REFR_PERIOD);
+  }
+
+  display->account_busy(k_cycle_get_32() - start);
+  perf::loop_end();
+
+  // the ambient watchface has no seconds, once the minute is drawn only a posted message wakes it
+  // before the next one
+  if (display->_ambient_active)
+  {
+    if (lv_disp_get_default()->inv_p == 0)
+    {
+      next = (60 - now_ts.tv_sec % 60) * MSEC_PER_SEC - now_ts.tv_nsec / NSEC_PER_MSEC;
+    }
+    k_work_schedule_for_queue(&display->_work_q, &display->_render_work, K_MSEC(next));
+    return;
+  }
+
+  // pace the loop to the panel refresh when the TE line is wired up
+  if (next == 0 && gc9a01_on_next_te(display->_display, render_te_cb, display) == 0)
+  {
+    return;
+  }
+  k_work_schedule_for_queue(&display->_work_q, &display->_render_work, K_MSEC(next));
+}
+
+void Display::render_te_cb(const device *dev, void *user_data)
+{
+  auto *display = (Display *)user_data;
+  k_work_schedule_for_queue(&display->_work_q, &display->_render_work, K_NO_WAIT);
 }
\ No newline at end of file
@@ -6,15 +6,44 @@
 #include <zephyr/drivers/pwm.h>
 #include <zephyr/drivers/counter.h>
 
+#include "managers/draw_buffers.hpp"
+#include "ui/flush_filter.hpp"
+#include "ui/hw_scroll.hpp"
+#include "ui/navigation.hpp"
+#include "ui/round_mask.hpp"
+#include "ui/solid_fill.hpp"
+#include "ui/time_model.hpp"
+#include "ui/touch_filter.hpp"
+
+#include <lvgl.h>
+
 #include <cstdint>
 
 namespace managers::display
 {
+  // UI updates posted from outside of the display thread.
+  struct Message
+  {
+    enum Type : uint8_t
+    {
+      BluetoothConnected,
+      BluetoothDisconnected,
+      TouchGesture,
+    } type;
+    ui::Gesture gesture; // TouchGesture
+  };
+
+  // LVGL is not thread safe, every lvgl call has to happen on the display work queue: in the render
+  // loop, in lvgl event callbacks or while handling a posted Message. Other subsystems (bluetooth,
+  // input, devkit) must never touch lvgl objects directly and use Display::post instead. The public
+  // methods below are safe to call from any thread unless noted otherwise.
   class Display
   {
     enum State
     {
       On,
+      // always-on watchface, only the band of the time label is driven and redrawn once a minute
+      Ambient,
       Sleep,
       // Off, // requires external regulator
     };
@@ -25,13 +54,35 @@ namespace managers::display
 
     static Display &instance();
     void init();
+
+    // Queues a UI update for the display thread, safe to call from an interrupt.
+    int post(const Message &msg);
+    // The power transitions are sequenced on the display thread, these only set where to go and
+    // return right away.
     void on();
+    // Low power always-on watchface, on() goes back to normal.
+    void ambient();
     void sleep();
     // void off(); // requires external regulator
 
     void set_brightness(uint8_t brightness);
     uint8_t get_brightness();
 
+    // Wakes the render loop right away, call after changing lvgl objects from outside of it.
+    void request_render();
+    // Called for every touch input event, resumes lvgl input polling until the touch is released.
+    // A synced event is one sample queued for lvgl.
+    void touch_activity(bool sync);
+    // Share of the last second the render loop was not running, in percent.
+    uint8_t cpu_idle();
+    // Scrolls obj with the panel's scroll registers so only the lines scrolling into view are rendered,
+    // see ui::HwScroll for what obj has to look like. Only one object at a time, a null obj unbinds
+    // it. Call from the display thread.
+    int scroll_with_panel(lv_obj_t *obj);
+    // Sends screen in 12-bit color while it is active, for animation heavy screens where the bus is
+    // the bottleneck. Ambient mode always uses it. Call from the display thread.
+    void reduce_color(lv_obj_t *screen, bool reduce);
+
   private:
     Display(const device *display, const device *touch, const device *counter, const pwm_dt_spec backlight);
     ~Display() = default;
@@ -40,12 +91,75 @@ namespace managers::display
     const device *_counter;
     const pwm_dt_spec _backlight;
     uint8_t _brightness{32}, _last_brightness{32};
+    // _state is where the caller wants the display to be, _powered where the panel and touch
+    // controller have been switched to
     State _state{Sleep};
+    State _powered{Sleep};
+    // from leaving sleep until the first frame is out, the panel is switched on and lit after it
+    bool _waking{false};
     counter_alarm_cfg _brightness_alarm_start, _brightness_alarm_run, _brightness_alarm_stop;
+    // the backlight is driven by a pwm and a timer that native_sim doesn't have
+    bool has_backlight() const { return _backlight.dev != nullptr && _counter != nullptr; }
+
+    static void flush_cb(lv_disp_drv_t *disp_drv, const lv_area_t *area, lv_color_t *color_p);
+    static void flush_done_cb(const device *dev, int result, void *user_data);
+    // completes every part of a band but the last, which calls flush_done_cb
+    static void flush_part_cb(const device *dev, int result, void *user_data);
+    // completes a band that wasn't sent because the panel already shows it
+    static void flush_skipped(lv_disp_drv_t *disp_drv);
+    static void flush_wait_cb(lv_disp_drv_t *disp_drv);
+    k_sem _flush_sem;
+    ui::SolidFill _solid_fill;
+    ui::FlushFilter _flush_filter;
+    // the band being sent, forgotten by the filter if sending any of its parts fails
+    lv_area_t _flush_area{};
+    bool _flush_failed{false};
+    ui::RoundMask _round_mask;
+    ui::HwScroll _hw_scroll;
+    DrawBuffers _draw_buffers;
+
+    k_work_q _work_q;
+    k_msgq _msgq;
+    char __aligned(4) _msgq_buf[CONFIG_NRF_TEST_DISPLAY_MSGQ_SIZE * sizeof(Message)];
+    void handle(const Message &msg);
+
+    static void do_init(k_work *work);
+    K_WORK_DEFINE(_init_work, do_init);
+
+    static void power(k_work *work);
+    K_WORK_DELAYABLE_DEFINE(_power_work, power);
+    // milliseconds until action can run on the panel, 0 if it doesn't run at all
+    int32_t panel_toggle_in(pm_device_action action) const;
+    void power_up(State from);
+    // touch on the suspended controller, from its interrupt
+    static void touch_wake_cb(const device *dev, void *user_data);
+    atomic_t _touch_woke{ATOMIC_INIT(0)};
+    void power_down();
+    uint8_t lit_brightness() const;
+
+    ui::TimeModel _time_model;
+
+    // the ambient panel mode is entered and left by the render loop since both touch lvgl
+    void enter_ambient();
+    void exit_ambient();
+    void update_color_depth();
+    bool _ambient_active{false};
+    lv_area_t _ambient_band{};
 
     static void render(k_work *work);
+    static void render_te_cb(const device *dev, void *user_data);
+    uint32_t schedule_input(uint32_t next);
+    uint32_t schedule_refresh(uint32_t next);
+    void account_busy(uint32_t cycles);
+    lv_indev_t *_touch_indev{nullptr};
+    ui::TouchFilter _touch_filter;
+    ui::Navigation _navigation;
+    atomic_t _touch_pending{ATOMIC_INIT(0)};
+    int64_t _touch_last{0};
+    uint32_t _busy_cycles{0};
+    uint32_t _busy_window_start{0};
+    uint8_t _cpu_idle{100};
     K_WORK_DELAYABLE_DEFINE(_render_work, render);
-    k_work_sync _render_cancel_sync;
 
     static void do_set_brightness(k_work *work);
     K_WORK_DELAYABLE_DEFINE(_brightness_work, do_set_brightness);
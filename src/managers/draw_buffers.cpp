@@ -0,0 +1,186 @@
+#include "managers/draw_buffers.hpp"
+
+#include <zephyr/kernel.h>
+#include <zephyr/devicetree.h>
+#include <zephyr/logging/log.h>
+
+#include <algorithm>
+
+using namespace managers::display;
+
+LOG_MODULE_DECLARE(nrf_test_display, CONFIG_NRF_TEST_LOG_LEVEL);
+
+constexpr uint32_t WIDTH = DT_PROP(DT_CHOSEN(zephyr_display), width);
+constexpr uint32_t HEIGHT = DT_PROP(DT_CHOSEN(zephyr_display), height);
+
+constexpr uint32_t SINGLE_PX = WIDTH * CONFIG_NRF_TEST_DISPLAY_VDB_SINGLE_ROWS;
+constexpr uint32_t DOUBLE_PX = WIDTH * CONFIG_NRF_TEST_DISPLAY_VDB_DOUBLE_ROWS;
+constexpr uint32_t FULL_PX = WIDTH * HEIGHT;
+
+// growing switches right away so the first frame of an animation already gets the bigger buffers,
+// shrinking waits for this many updates in a row
+constexpr uint8_t SHRINK_VOTES = 8;
+
+static const char *const mode_names[] = {"static", "single band", "double band", "full frame"};
+
+// monitor_cb is a plain function pointer, there is only one display to watch
+static DrawBuffers *hooked = nullptr;
+
+void DrawBuffers::attach(lv_disp_t *disp)
+{
+  _disp = disp;
+  hooked = this;
+
+  auto *draw_buf = disp->driver->draw_buf;
+  _static_buf1 = draw_buf->buf1;
+  _static_buf2 = draw_buf->buf2;
+  _static_size = draw_buf->size;
+
+  disp->driver->monitor_cb = monitor_cb;
+
+  // start small, the first refreshes grow it if they need to
+  _next = SingleBand;
+  apply();
+}
+
+void DrawBuffers::monitor_cb(lv_disp_drv_t *disp_drv, uint32_t time, uint32_t px)
+{
+  auto *buffers = hooked;
+  buffers->_last_px += px;
+}
+
+DrawBuffers::Mode DrawBuffers::pick() const
+{
+  if (IS_ENABLED(CONFIG_NRF_TEST_DISPLAY_VDB_FULL_FRAME) && _full_frame_ok &&
+      (lv_anim_count_running() > 0 || _stats.avg_px >= FULL_PX / 2))
+  {
+    return FullFrame;
+  }
+  if (lv_anim_count_running() > 0 || _stats.avg_px > SINGLE_PX)
+  {
+    return DoubleBand;
+  }
+  return SingleBand;
+}
+
+bool DrawBuffers::update()
+{
+  // only refreshes that rendered something count, an idle clock keeps its buffers
+  if (_last_px == 0)
+  {
+    return false;
+  }
+  _stats.refreshes++;
+  _stats.avg_px = _stats.avg_px - _stats.avg_px / 4 + _last_px / 4;
+  _last_px = 0;
+
+  auto mode = pick();
+  if (mode == _mode)
+  {
+    _votes = 0;
+    return false;
+  }
+  if (mode != _next)
+  {
+    _next = mode;
+    _votes = 0;
+  }
+  _votes++;
+  return _next > _mode || _votes >= SHRINK_VOTES;
+}
+
+bool DrawBuffers::allocate_bands()
+{
+  if (_band1 != nullptr)
+  {
+    return true;
+  }
+  // the single band lives at the start of the first one
+  _band1 = k_malloc(std::max(SINGLE_PX, DOUBLE_PX) * sizeof(lv_color_t));
+  _band2 = k_malloc(DOUBLE_PX * sizeof(lv_color_t));
+  if (_band1 == nullptr || _band2 == nullptr)
+  {
+    k_free(_band1);
+    k_free(_band2);
+    _band1 = _band2 = nullptr;
+    return false;
+  }
+  return true;
+}
+
+bool DrawBuffers::use(Mode mode)
+{
+  auto *draw_buf = _disp->driver->draw_buf;
+  switch (mode)
+  {
+  case Static:
+    lv_disp_draw_buf_init(draw_buf, _static_buf1, _static_buf2, _static_size);
+    break;
+  case SingleBand:
+    if (!allocate_bands())
+      return false;
+    lv_disp_draw_buf_init(draw_buf, _band1, nullptr, SINGLE_PX);
+    break;
+  case DoubleBand:
+    if (!allocate_bands())
+      return false;
+    lv_disp_draw_buf_init(draw_buf, _band1, _band2, DOUBLE_PX);
+    break;
+  case FullFrame:
+    if (_full == nullptr)
+    {
+      _full = k_malloc(FULL_PX * sizeof(lv_color_t));
+    }
+    if (_full == nullptr)
+      return false;
+    lv_disp_draw_buf_init(draw_buf, _full, nullptr, FULL_PX);
+    return true;
+  }
+
+  // only the full frame is big enough to be worth handing back
+  k_free(_full);
+  _full = nullptr;
+  return true;
+}
+
+void DrawBuffers::apply()
+{
+  _votes = 0;
+  // a full frame is only retried once the buffers shrank back to a single band, the heap is unlikely
+  // to have more room before that
+  if (_next == SingleBand)
+  {
+    _full_frame_ok = true;
+  }
+
+  // on failure fall back to the next smaller mode down to the glue's static buffers
+  auto mode = _next;
+  for (; mode > Static; mode = Mode(mode - 1))
+  {
+    if (use(mode))
+    {
+      break;
+    }
+    _stats.alloc_fails++;
+    if (mode == FullFrame)
+    {
+      _full_frame_ok = false;
+    }
+  }
+  if (mode == Static)
+  {
+    // the static buffers are always there
+    use(Static);
+  }
+
+  if (mode != _next)
+  {
+    LOG_WRN("No heap for %s draw buffers, using %s", mode_names[_next], mode_names[mode]);
+  }
+  if (mode != _mode)
+  {
+    LOG_DBG("Draw buffers: %s", mode_names[mode]);
+    _stats.switches++;
+  }
+  _mode = _next = mode;
+}
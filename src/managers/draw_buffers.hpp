@@ -0,0 +1,70 @@
+#pragma once
+
+#include <lvgl.h>
+
+#include <cstdint>
+
+namespace managers::display
+{
+  struct DrawBufferStats
+  {
+    uint32_t switches;     // rendering mode changes
+    uint32_t alloc_fails;  // modes that couldn't be allocated, the previous one was kept
+    uint32_t refreshes;    // refreshes that rendered something
+    uint32_t avg_px;       // moving average of the pixels rendered per refresh
+  };
+
+  // LVGL draw buffers allocated from the system heap and resized at runtime. A ticking clock only
+  // dirties a few hundred pixels and gets a single small band, anything larger gets two bands so a
+  // band is rendered while the previous one is sent, and animations get a full frame when the heap
+  // has room for it. The two bands are allocated once and the single band is the start of the first
+  // one, so switching between them only changes lvgl's pointers and doesn't fragment the heap. Only
+  // the full frame goes back to the heap when it is left.
+  class DrawBuffers
+  {
+  public:
+    enum Mode : uint8_t
+    {
+      Static,     // the buffers of the zephyr lvgl glue, until the first switch or if allocation fails
+      SingleBand, // one buffer of CONFIG_NRF_TEST_DISPLAY_VDB_SINGLE_ROWS rows
+      DoubleBand, // two buffers of CONFIG_NRF_TEST_DISPLAY_VDB_DOUBLE_ROWS rows
+      FullFrame,  // one buffer for the whole screen
+    };
+
+    void attach(lv_disp_t *disp);
+
+    // Picks the mode for the next refreshes from the dirty area stats, returns true when it differs
+    // from the current one. Call between refreshes.
+    bool update();
+    // Switches to the mode picked by update. No flush may be in flight.
+    void apply();
+
+    Mode mode() const { return _mode; }
+    const DrawBufferStats &stats() const { return _stats; }
+
+  private:
+    static void monitor_cb(lv_disp_drv_t *disp_drv, uint32_t time, uint32_t px);
+    Mode pick() const;
+    // Points lvgl at the buffers of mode, allocating them if needed. False if the heap has no room.
+    bool use(Mode mode);
+    bool allocate_bands();
+
+    lv_disp_t *_disp{nullptr};
+    Mode _mode{Static};
+    Mode _next{Static};
+    // how many updates in a row picked _next, switches need a few to avoid flapping
+    uint8_t _votes{0};
+    bool _full_frame_ok{true};
+
+    void *_band1{nullptr};
+    void *_band2{nullptr};
+    void *_full{nullptr};
+    // the glue's buffers, kept as the fallback
+    void *_static_buf1{nullptr};
+    void *_static_buf2{nullptr};
+    uint32_t _static_size{0};
+
+    uint32_t _last_px{0};
+    DrawBufferStats _stats{};
+  };
+}
@@ -0,0 +1,100 @@
+#include "drivers/display/gc9a01_emul.hpp"
+#include "managers/display.hpp"
+#include "perf/profiler.hpp"
+
+#include <zephyr/drivers/emul.h>
+#include <zephyr/init.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+
+LOG_MODULE_REGISTER(nrf_test_ambient_bench, CONFIG_NRF_TEST_LOG_LEVEL);
+
+using managers::display::Display;
+
+// Runs on native_sim: lets the watchface run on and in ambient mode for the same stretch of simulated
+// time and estimates the energy per hour of both from the bus and cpu time they used. Without
+// --rt the simulated minutes pass in moments.
+
+constexpr auto BENCH_START_DELAY_MS = 10000; // after the emulator benchmark
+constexpr auto BENCH_PHASE_MIN = 10;
+
+// Rough current model at 3 V, adjust to the hardware at hand. The cpu time is measured on the host
+// and only good for comparing the two modes.
+constexpr uint32_t SUPPLY_MV = 3000;
+constexpr uint32_t CPU_ACTIVE_UA = 6000;  // app core at 128 MHz
+constexpr uint32_t SPI_ACTIVE_UA = 1000;  // SPIM4 while clocking out pixels
+constexpr uint32_t PANEL_NORMAL_UA = 4000;
+constexpr uint32_t PANEL_AMBIENT_UA = 800; // partial area, eight colors, slower frame rate
+constexpr uint32_t BACKLIGHT_FULL_UA = 15000;
+
+static const emul *display_emul = EMUL_DT_GET(DT_NODELABEL(gc9a01));
+
+struct Phase
+{
+  const char *name;
+  uint32_t panel_ua;
+};
+
+static const Phase phases[] = {
+    {"on", PANEL_NORMAL_UA},
+    {"ambient", PANEL_AMBIENT_UA},
+};
+static size_t phase;
+
+static void bench_phase(k_work *work);
+K_WORK_DELAYABLE_DEFINE(bench_phase_work, bench_phase);
+
+static void bench_report(const Phase &p)
+{
+  perf::DisplayStats stats;
+  perf::get(&stats);
+  gc9a01_emul_stats_t bus;
+  gc9a01_emul_get_stats(display_emul, &bus);
+
+  uint64_t window_us = uint64_t(stats.window_ms) * USEC_PER_MSEC;
+  if (window_us == 0)
+  {
+    return;
+  }
+
+  // average current over the phase in uA
+  uint64_t cpu_ua = uint64_t(CPU_ACTIVE_UA) * stats.loop.sum_us / window_us;
+  uint64_t spi_ua = uint64_t(SPI_ACTIVE_UA) * bus.bus_us / window_us;
+  uint64_t backlight_ua = uint64_t(BACKLIGHT_FULL_UA) * Display::instance().get_brightness() / 32;
+  uint64_t total_ua = cpu_ua + spi_ua + p.panel_ua + backlight_ua;
+
+  LOG_INF("%s: %u wakeups, %u frames, %llu bytes, %llu us on the bus in %u ms",
+          p.name, stats.loop.count, stats.frames, bus.data_bytes + bus.cmd_bytes, bus.bus_us, stats.window_ms);
+  LOG_INF("%s: %llu uA avg (cpu %llu, spi %llu, panel %u, backlight %llu), %llu uAh and %llu mJ per hour",
+          p.name, total_ua, cpu_ua, spi_ua, p.panel_ua, backlight_ua,
+          total_ua, total_ua * SUPPLY_MV * 3600 / 1000000);
+}
+
+static void bench_phase(k_work *work)
+{
+  if (phase > 0)
+  {
+    bench_report(phases[phase - 1]);
+  }
+  if (phase == ARRAY_SIZE(phases))
+  {
+    Display::instance().on();
+    return;
+  }
+
+  if (phase == 1)
+  {
+    Display::instance().ambient();
+  }
+  perf::reset();
+  gc9a01_emul_reset_stats(display_emul);
+  phase++;
+  k_work_schedule(&bench_phase_work, K_MINUTES(BENCH_PHASE_MIN));
+}
+
+static int bench_init()
+{
+  k_work_schedule(&bench_phase_work, K_MSEC(BENCH_START_DELAY_MS));
+  return 0;
+}
+SYS_INIT(bench_init, APPLICATION, 99);
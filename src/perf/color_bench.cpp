@@ -0,0 +1,60 @@
+#include "drivers/display/color.hpp"
+
+#include <zephyr/init.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/timing/timing.h>
+
+#include <array>
+
+LOG_MODULE_REGISTER(nrf_test_color_bench, CONFIG_NRF_TEST_LOG_LEVEL);
+
+// Times the color conversion kernels on one display row, logged once after boot.
+
+constexpr size_t ROW_PIXELS = 240;
+constexpr size_t ROUNDS = 200;
+
+static std::array<uint32_t, ROW_PIXELS> src;
+// one spare pixel so the unaligned case can be timed as well
+static std::array<uint16_t, ROW_PIXELS + 1> dst;
+
+template <typename Fn>
+static void bench(const char *name, Fn fn)
+{
+  timing_t start = timing_counter_get();
+  for (size_t i = 0; i < ROUNDS; ++i)
+  {
+    fn();
+  }
+  timing_t end = timing_counter_get();
+  uint64_t ns = timing_cycles_to_ns(timing_cycles_get(&start, &end));
+  LOG_INF("%s: %llu ns per row, %llu ps per pixel", name, ns / ROUNDS, ns * 1000 / (ROUNDS * ROW_PIXELS));
+}
+
+static int color_bench()
+{
+  timing_init();
+  timing_start();
+
+  uint32_t seed = 0x12345678;
+  for (auto &p : src)
+  {
+    seed = seed * 1664525 + 1013904223;
+    p = seed & 0xFFFFFF;
+  }
+
+  bench("scalar", []
+        {
+          for (size_t i = 0; i < ROW_PIXELS; ++i)
+          {
+            dst[i] = color::rgb565_swapped(src[i]);
+          } });
+  bench("row", []
+        { color::convert_row(src.data(), dst.data(), ROW_PIXELS); });
+  bench("row swapped", []
+        { color::convert_row_swapped(src.data(), dst.data(), ROW_PIXELS); });
+  bench("row swapped unaligned", []
+        { color::convert_row_swapped(src.data(), dst.data() + 1, ROW_PIXELS); });
+  return 0;
+}
+SYS_INIT(color_bench, APPLICATION, 99);
@@ -0,0 +1,236 @@
+#include "drivers/display/gc9a01_emul.hpp"
+#include "drivers/input/cst816s.hpp"
+#include "drivers/input/cst816s_emul.hpp"
+#include "managers/display.hpp"
+#include "perf/profiler.hpp"
+
+#include <zephyr/drivers/emul.h>
+#include <zephyr/init.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+
+#include <array>
+
+#ifdef CONFIG_ARCH_POSIX
+#include <posix_board_if.h>
+#endif
+
+LOG_MODULE_REGISTER(nrf_test_bench, CONFIG_NRF_TEST_LOG_LEVEL);
+
+// Runs on native_sim: waits for the first frame, replays a drag across the panel and logs what the
+// display and touch pipeline did with it. The run is deterministic, so numbers can be compared
+// between builds. After that the display is put to sleep and woken a few times to measure how long
+// it takes until the first frame is shown. With CONFIG_INPUT_CST816S_WAKE it is woken by a tap on the
+// suspended touch controller, and the current the controller draws while asleep is estimated.
+// A failed check ends the native_sim process with exit status 1, for CI.
+
+constexpr auto BENCH_START_DELAY_MS = 2000;
+constexpr auto BENCH_SETTLE_MS = 1000;
+constexpr auto BENCH_WAKE_CYCLES = 3;
+// longer than the 120 ms the panel needs between SLPIN and SLPOUT, and with wake on touch than the
+// second until the touch controller drops to its low power scan
+constexpr auto BENCH_ASLEEP_MS = IS_ENABLED(CONFIG_INPUT_CST816S_WAKE) ? 1500 : 150;
+constexpr auto BENCH_AWAKE_MS = 100;
+
+// Rough CST816S current model, adjust to the datasheet of the part at hand.
+constexpr uint32_t TOUCH_ACTIVE_UA = 2500;
+constexpr uint32_t TOUCH_STANDBY_UA = 50; // low power scan at the default frequency
+constexpr uint32_t TOUCH_RESET_UA = 5;
+
+enum BenchEvent : uint8_t
+{
+  PressDown = 0x00,
+  LiftUp = 0x01,
+  Contact = 0x02,
+};
+
+constexpr uint8_t GESTURE_NONE = 0x00;
+constexpr uint8_t GESTURE_RIGHT_SLIDE = 0x04;
+
+// low power scan registers the driver sets up before suspending with wake on touch
+constexpr uint8_t REG_LP_SCAN_TH = 0xF5;
+constexpr uint8_t REG_LP_SCAN_FREQ = 0xF7;
+constexpr uint8_t REG_DIS_AUTO_SLEEP = 0xFE;
+
+// a finger resting in the middle, then dragged right at about 60 Hz and lifted with a swipe
+static constexpr auto drag_trace = []
+{
+  std::array<cst816s_emul_sample_t, 34> trace{};
+  trace[0] = {.delay_ms = 0, .x = 60, .y = 120, .event = PressDown, .gesture = GESTURE_NONE};
+  for (size_t i = 1; i < trace.size() - 1; ++i)
+  {
+    trace[i] = {.delay_ms = 16, .x = uint16_t(60 + i * 4), .y = 120, .event = Contact, .gesture = GESTURE_NONE};
+  }
+  trace.back() = {.delay_ms = 16, .x = 190, .y = 120, .event = LiftUp, .gesture = GESTURE_RIGHT_SLIDE};
+  return trace;
+}();
+
+static const emul *display_emul = EMUL_DT_GET(DT_NODELABEL(gc9a01));
+static const emul *touch_emul = EMUL_DT_GET(DT_NODELABEL(cst816s));
+static const device *touch_dev = DEVICE_DT_GET(DT_NODELABEL(cst816s));
+
+static void bench_report(k_work *work);
+K_WORK_DELAYABLE_DEFINE(bench_report_work, bench_report);
+
+// a short tap, the press is what wakes the display
+static const cst816s_emul_sample_t wake_trace[] = {
+    {.delay_ms = 0, .x = 120, .y = 120, .event = PressDown, .gesture = GESTURE_NONE},
+    {.delay_ms = 50, .x = 120, .y = 120, .event = LiftUp, .gesture = GESTURE_NONE},
+};
+
+static int wake_cycle;
+// touch controller power states summed over the asleep phases
+static cst816s_emul_stats_t asleep;
+static int failures;
+
+static void bench_check(bool ok, const char *what)
+{
+  if (!ok)
+  {
+    LOG_ERR("bench check failed: %s", what);
+    failures++;
+  }
+}
+
+// Logs the outcome, a failed run ends the process so CI sees it.
+static void bench_finish()
+{
+  if (failures == 0)
+  {
+    LOG_INF("bench: passed");
+    return;
+  }
+  LOG_ERR("bench: FAILED, %d checks", failures);
+#ifdef CONFIG_ARCH_POSIX
+  LOG_PANIC();
+  posix_exit(1);
+#endif
+}
+
+static void bench_sleep(managers::display::Display &display)
+{
+  cst816s_emul_reset_stats(touch_emul);
+  display.sleep();
+}
+
+static void bench_wake(k_work *work)
+{
+  auto &display = managers::display::Display::instance();
+
+  // odd steps wake, even ones put it back to sleep or report once all cycles are done
+  wake_cycle++;
+  if (wake_cycle % 2 == 1)
+  {
+    cst816s_emul_stats_t touch;
+    cst816s_emul_get_stats(touch_emul, &touch);
+    asleep.active_ms += touch.active_ms;
+    asleep.standby_ms += touch.standby_ms;
+    asleep.reset_ms += touch.reset_ms;
+    bench_check(touch.nacked == 0, "touch controller addressed while in reset");
+
+    if (IS_ENABLED(CONFIG_INPUT_CST816S_WAKE))
+    {
+      bench_check(cst816s_emul_reg_written(touch_emul, REG_LP_SCAN_TH) == CONFIG_INPUT_CST816S_LP_SCAN_THRESHOLD,
+                  "low power scan threshold not set");
+      bench_check(cst816s_emul_reg_written(touch_emul, REG_LP_SCAN_FREQ) == CONFIG_INPUT_CST816S_LP_SCAN_FREQ,
+                  "low power scan frequency not set");
+      bench_check(cst816s_emul_reg_written(touch_emul, REG_DIS_AUTO_SLEEP) == 0, "auto sleep not enabled");
+      cst816s_emul_play(touch_emul, wake_trace, ARRAY_SIZE(wake_trace));
+    }
+    else
+    {
+      display.on();
+    }
+    k_work_schedule(k_work_delayable_from_work(work), K_MSEC(BENCH_AWAKE_MS));
+    return;
+  }
+  if (wake_cycle < 2 * BENCH_WAKE_CYCLES)
+  {
+    bench_sleep(display);
+    k_work_schedule(k_work_delayable_from_work(work), K_MSEC(BENCH_ASLEEP_MS));
+    return;
+  }
+
+  perf::DisplayStats stats;
+  perf::get(&stats);
+  LOG_INF("wake: %u of %u cycles, first frame shown after avg %uus max %uus",
+          stats.wake.count, BENCH_WAKE_CYCLES, stats.wake.avg_us(), stats.wake.max_us);
+  cst816s_stats_t reported;
+  cst816s_get_stats(touch_dev, &reported);
+  LOG_INF("touch: %u warm resumes, %u resets", reported.warm_resumes, reported.resets);
+  bench_check(stats.wake.count == BENCH_WAKE_CYCLES, "display didn't wake every cycle");
+  if (IS_ENABLED(CONFIG_INPUT_CST816S_WAKE))
+  {
+    bench_check(reported.warm_resumes == BENCH_WAKE_CYCLES, "touch controller wasn't resumed warm every cycle");
+  }
+
+  uint64_t asleep_ms = uint64_t(asleep.active_ms) + asleep.standby_ms + asleep.reset_ms;
+  if (asleep_ms == 0)
+  {
+    bench_finish();
+    return;
+  }
+  uint64_t touch_ua = (uint64_t(TOUCH_ACTIVE_UA) * asleep.active_ms + uint64_t(TOUCH_STANDBY_UA) * asleep.standby_ms +
+                       uint64_t(TOUCH_RESET_UA) * asleep.reset_ms) /
+                      asleep_ms;
+  LOG_INF("touch asleep: %u ms active, %u ms low power scan, %u ms in reset, %llu uA avg",
+          asleep.active_ms, asleep.standby_ms, asleep.reset_ms, touch_ua);
+  bench_finish();
+}
+K_WORK_DELAYABLE_DEFINE(bench_wake_work, bench_wake);
+
+static void bench_start(k_work *work)
+{
+  perf::reset();
+  gc9a01_emul_reset_stats(display_emul);
+  cst816s_emul_reset_stats(touch_emul);
+  cst816s_reset_stats(touch_dev);
+
+  cst816s_emul_play(touch_emul, drag_trace.data(), drag_trace.size());
+
+  uint32_t duration = BENCH_SETTLE_MS;
+  for (const auto &sample : drag_trace)
+  {
+    duration += sample.delay_ms;
+  }
+  k_work_schedule(&bench_report_work, K_MSEC(duration));
+}
+K_WORK_DELAYABLE_DEFINE(bench_start_work, bench_start);
+
+static void bench_report(k_work *work)
+{
+  gc9a01_emul_stats_t display;
+  gc9a01_emul_get_stats(display_emul, &display);
+  LOG_INF("panel: %u transfers, %u commands, %u windows, %u writes",
+          display.transactions, display.commands, display.windows, display.writes);
+  LOG_INF("panel: %llu cmd bytes, %llu data bytes, %llu px, %llu us on the bus",
+          display.cmd_bytes, display.data_bytes, display.pixels, display.bus_us);
+
+  cst816s_emul_stats_t touch;
+  cst816s_emul_get_stats(touch_emul, &touch);
+  auto read_samples = touch.samples - touch.missed;
+  LOG_INF("touch: %u samples, %u reads, %u missed, latency avg %uus max %uus",
+          touch.samples, touch.reads, touch.missed,
+          read_samples ? uint32_t(touch.latency_sum_us / read_samples) : 0, touch.latency_max_us);
+  cst816s_stats_t reported;
+  cst816s_get_stats(touch_dev, &reported);
+  LOG_INF("touch: %u reported, %u read from the interrupt, %u errors, %u events dropped, to report avg %uus max %uus",
+          reported.samples, reported.async_reads, reported.errors, reported.dropped,
+          reported.samples ? uint32_t(reported.latency_sum_us / reported.samples) : 0, reported.latency_max_us);
+  bench_check(touch.lost == 0 && touch.nacked == 0, "touch controller held in reset during the drag");
+  bench_check(reported.errors == 0, "touch driver reported errors");
+  bench_check(reported.dropped == 0, "touch events dropped by the input queue");
+
+  perf::log();
+
+  perf::reset();
+  bench_sleep(managers::display::Display::instance());
+  k_work_schedule(&bench_wake_work, K_MSEC(BENCH_ASLEEP_MS));
+}
+
+static int bench_init()
+{
+  k_work_schedule(&bench_start_work, K_MSEC(BENCH_START_DELAY_MS));
+  return 0;
+}
+SYS_INIT(bench_init, APPLICATION, 99);
@@ -0,0 +1,211 @@
+#include "perf/profiler.hpp"
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/timing/timing.h>
+
+#include <algorithm>
+#include <bit>
+#include <cstdarg>
+#include <cstdio>
+
+LOG_MODULE_REGISTER(nrf_test_perf, CONFIG_NRF_TEST_LOG_LEVEL);
+
+using namespace perf;
+
+// flush_end runs in the SPI interrupt, everything below is guarded by the spinlock
+static k_spinlock lock;
+static DisplayStats stats;
+static int64_t window_start;
+
+static timing_t render_start;
+static timing_t loop_start;
+static timing_t wake_start;
+static uint32_t render_flushes;
+static timing_t flush_start;
+static timing_t flush_last_end;
+static bool flush_in_frame;
+
+static uint32_t elapsed_us(timing_t start, timing_t end)
+{
+  return uint32_t(timing_cycles_to_ns(timing_cycles_get(&start, &end)) / NSEC_PER_USEC);
+}
+
+void Stat::add(uint32_t us)
+{
+  min_us = count == 0 ? us : std::min(min_us, us);
+  max_us = std::max(max_us, us);
+  sum_us += us;
+  count++;
+  auto bucket = us < 2 ? 0 : std::bit_width(us) - 1;
+  histogram[std::min<size_t>(bucket, Buckets - 1)]++;
+}
+
+void perf::init()
+{
+  timing_init();
+  timing_start();
+  reset();
+}
+
+void perf::render_begin()
+{
+  auto now = timing_counter_get();
+  k_spinlock_key_t key = k_spin_lock(&lock);
+  render_start = now;
+  render_flushes = 0;
+  flush_in_frame = false;
+  k_spin_unlock(&lock, key);
+}
+
+void perf::render_end()
+{
+  auto now = timing_counter_get();
+  k_spinlock_key_t key = k_spin_lock(&lock);
+  if (render_flushes > 0)
+  {
+    stats.render.add(elapsed_us(render_start, now));
+    stats.frames++;
+  }
+  k_spin_unlock(&lock, key);
+}
+
+void perf::loop_begin()
+{
+  loop_start = timing_counter_get();
+}
+
+void perf::loop_end()
+{
+  auto now = timing_counter_get();
+  k_spinlock_key_t key = k_spin_lock(&lock);
+  stats.loop.add(elapsed_us(loop_start, now));
+  k_spin_unlock(&lock, key);
+}
+
+void perf::wake_begin()
+{
+  wake_start = timing_counter_get();
+}
+
+void perf::wake_end()
+{
+  auto now = timing_counter_get();
+  k_spinlock_key_t key = k_spin_lock(&lock);
+  stats.wake.add(elapsed_us(wake_start, now));
+  k_spin_unlock(&lock, key);
+}
+
+void perf::flush_begin(uint32_t pixels, uint32_t bytes)
+{
+  auto now = timing_counter_get();
+  k_spinlock_key_t key = k_spin_lock(&lock);
+  if (flush_in_frame)
+  {
+    stats.bus_idle.add(elapsed_us(flush_last_end, now));
+  }
+  flush_start = now;
+  render_flushes++;
+  stats.pixels += pixels;
+  stats.bytes += bytes;
+  k_spin_unlock(&lock, key);
+}
+
+void perf::flush_end()
+{
+  auto now = timing_counter_get();
+  k_spinlock_key_t key = k_spin_lock(&lock);
+  auto us = elapsed_us(flush_start, now);
+  stats.flush.add(us);
+  stats.bus_busy_us += us;
+  flush_last_end = now;
+  flush_in_frame = true;
+  k_spin_unlock(&lock, key);
+}
+
+void perf::flush_skip()
+{
+  k_spinlock_key_t key = k_spin_lock(&lock);
+  stats.skipped++;
+  k_spin_unlock(&lock, key);
+}
+
+void perf::get(DisplayStats *out)
+{
+  k_spinlock_key_t key = k_spin_lock(&lock);
+  *out = stats;
+  out->window_ms = uint32_t(k_uptime_get() - window_start);
+  k_spin_unlock(&lock, key);
+}
+
+void perf::reset()
+{
+  k_spinlock_key_t key = k_spin_lock(&lock);
+  stats = {};
+  window_start = k_uptime_get();
+  k_spin_unlock(&lock, key);
+}
+
+static void log_stat(const char *name, const Stat &stat)
+{
+  LOG_INF("%s: n %u min %uus avg %uus max %uus", name, stat.count, stat.min_us, stat.avg_us(), stat.max_us);
+  LOG_HEXDUMP_DBG(stat.histogram.data(), sizeof(stat.histogram), "log2 us histogram:");
+}
+
+void perf::log()
+{
+  DisplayStats s;
+  get(&s);
+  LOG_INF("%u frames, %llu px, %llu bytes in %u ms, %u bands skipped",
+          s.frames, s.pixels, s.bytes, s.window_ms, s.skipped);
+  LOG_INF("SPI %u B/s while sending, %u B/s average", s.bus_bytes_per_sec(), s.avg_bytes_per_sec());
+  log_stat("render", s.render);
+  log_stat("flush", s.flush);
+  log_stat("bus idle", s.bus_idle);
+  log_stat("loop", s.loop);
+  log_stat("wake", s.wake);
+}
+
+// snprintf that keeps counting past the end of buf so an overflow only has to be checked once
+static void __printf_like(4, 5) append(char *buf, size_t len, size_t &pos, const char *fmt, ...)
+{
+  auto off = std::min(pos, len);
+  va_list args;
+  va_start(args, fmt);
+  int n = vsnprintf(buf + off, len - off, fmt, args);
+  va_end(args);
+  pos += std::max(n, 0);
+}
+
+static void append_stat(char *buf, size_t len, size_t &pos, const char *name, const Stat &stat)
+{
+  append(buf, len, pos, "\"%s\":{\"n\":%u,\"min\":%u,\"avg\":%u,\"max\":%u,\"hist\":[",
+         name, stat.count, stat.min_us, stat.avg_us(), stat.max_us);
+  for (size_t i = 0; i < stat.histogram.size(); ++i)
+  {
+    append(buf, len, pos, i ? ",%u" : "%u", stat.histogram[i]);
+  }
+  append(buf, len, pos, "]}");
+}
+
+int perf::to_json(char *buf, size_t len)
+{
+  DisplayStats s;
+  get(&s);
+
+  size_t pos = 0;
+  append(buf, len, pos, "{\"t\":\"perf\",\"ms\":%u,\"frames\":%u,\"skipped\":%u,\"px\":%llu,\"bytes\":%llu,"
+                        "\"bus_bps\":%u,\"avg_bps\":%u,",
+         s.window_ms, s.frames, s.skipped, s.pixels, s.bytes, s.bus_bytes_per_sec(), s.avg_bytes_per_sec());
+  append_stat(buf, len, pos, "render", s.render);
+  append(buf, len, pos, ",");
+  append_stat(buf, len, pos, "flush", s.flush);
+  append(buf, len, pos, ",");
+  append_stat(buf, len, pos, "idle", s.bus_idle);
+  append(buf, len, pos, ",");
+  append_stat(buf, len, pos, "loop", s.loop);
+  append(buf, len, pos, ",");
+  append_stat(buf, len, pos, "wake", s.wake);
+  append(buf, len, pos, "}");
+  return pos < len ? int(pos) : -ENOMEM;
+}
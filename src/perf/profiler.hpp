@@ -0,0 +1,94 @@
+#pragma once
+
+#include <zephyr/sys/util.h>
+
+#include <errno.h>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+// Frame time and SPI throughput probes for the display pipeline. Durations are taken with the
+// timing api, which reads the DWT cycle counter on the nRF5340 and k_cycle_get on native_sim.
+namespace perf
+{
+  // Min/avg/max of a duration in microseconds and a log2 histogram of it.
+  struct Stat
+  {
+    static constexpr size_t Buckets = 16;
+
+    uint32_t count;
+    uint32_t min_us;
+    uint32_t max_us;
+    uint64_t sum_us;
+    // bucket 0 counts samples below 2us, bucket i samples in [2^i, 2^(i+1)) us, the last one
+    // everything above
+    std::array<uint32_t, Buckets> histogram;
+
+    void add(uint32_t us);
+    uint32_t avg_us() const { return count ? uint32_t(sum_us / count) : 0; }
+  };
+
+  struct DisplayStats
+  {
+    Stat render;   // lv_task_handler of a refresh that flushed something, flushes included
+    Stat flush;    // one band, from the bus being free until its pixels are clocked out
+    Stat bus_idle; // bus idle between two bands of the same refresh, time lost to rendering
+    Stat loop;     // every wakeup of the render loop, including the ones that didn't flush
+    Stat wake;     // from waking the panel until the first frame is shown
+    uint32_t frames;
+    uint32_t skipped; // bands the panel already showed, not sent and not counted in flush or bytes
+    uint64_t pixels;
+    uint64_t bytes;
+    uint64_t bus_busy_us; // sum of the flush times
+    uint32_t window_ms;   // time since the stats were last reset
+
+    // SPI throughput while a band is being sent and averaged over the whole window
+    uint32_t bus_bytes_per_sec() const { return bus_busy_us ? uint32_t(bytes * USEC_PER_SEC / bus_busy_us) : 0; }
+    uint32_t avg_bytes_per_sec() const { return window_ms ? uint32_t(bytes * MSEC_PER_SEC / window_ms) : 0; }
+  };
+
+#ifdef CONFIG_NRF_TEST_PROFILING
+  void init();
+
+  // Around lv_task_handler, only refreshes that flushed at least one band are counted as frames.
+  void render_begin();
+  void render_end();
+  // Around a whole pass of the render loop.
+  void loop_begin();
+  void loop_end();
+  // From leaving sleep until the panel is switched on with the first frame.
+  void wake_begin();
+  void wake_end();
+
+  // flush_begin is called once the previous band is out, flush_end from the transfer completion
+  // which can be an interrupt.
+  void flush_begin(uint32_t pixels, uint32_t bytes);
+  void flush_end();
+  // A band that completed without a transfer.
+  void flush_skip();
+
+  void get(DisplayStats *stats);
+  void reset();
+
+  // Writes the stats to the log backend.
+  void log();
+  // Formats the stats as a gadgetbridge style json object, returns the length or a negative error.
+  int to_json(char *buf, size_t len);
+#else
+  inline void init() {}
+  inline void render_begin() {}
+  inline void render_end() {}
+  inline void loop_begin() {}
+  inline void loop_end() {}
+  inline void wake_begin() {}
+  inline void wake_end() {}
+  inline void flush_begin(uint32_t pixels, uint32_t bytes) {}
+  inline void flush_end() {}
+  inline void flush_skip() {}
+  inline void get(DisplayStats *stats) { *stats = {}; }
+  inline void reset() {}
+  inline void log() {}
+  inline int to_json(char *buf, size_t len) { return -ENOTSUP; }
+#endif
+}
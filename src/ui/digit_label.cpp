@@ -0,0 +1,115 @@
+#include "ui/digit_label.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <string_view>
+
+using namespace ui;
+
+// every character the clock labels can show has to share one advance width
+static constexpr char CELL_CHARS[] = "0123456789:";
+
+DigitLabel::DigitLabel(lv_obj_t **label)
+    : _label(label)
+{
+}
+
+bool DigitLabel::attach(const char *text, LabelStats &stats)
+{
+  auto *label = *_label;
+  const auto *font = lv_obj_get_style_text_font(label, LV_PART_MAIN);
+  auto letter_space = lv_obj_get_style_text_letter_space(label, LV_PART_MAIN);
+
+  // the generated font tables carry the advance width and bitmap box of every glyph
+  _monospace = true;
+  _overhang_left = 0;
+  _overhang_right = 0;
+  uint16_t adv_w = lv_font_get_glyph_width(font, CELL_CHARS[0], 0);
+  for (auto c : std::string_view(CELL_CHARS))
+  {
+    lv_font_glyph_dsc_t dsc;
+    if (!lv_font_get_glyph_dsc(font, &dsc, c, 0) || dsc.adv_w != adv_w)
+    {
+      _monospace = false;
+      break;
+    }
+    _overhang_left = std::max<lv_coord_t>(_overhang_left, -dsc.ofs_x);
+    _overhang_right = std::max<lv_coord_t>(_overhang_right, dsc.ofs_x + dsc.box_w - adv_w);
+  }
+  _cell_w = adv_w + letter_space;
+
+  _len = std::min(std::strlen(text), _text.size() - 1);
+  std::copy_n(text, _len, _text.begin());
+  _text[_len] = '\0';
+
+  stats.dirty_px += lv_area_get_size(&label->coords);
+  lv_label_set_text_static(label, _text.data());
+  stats.sets++;
+
+  _attached = label;
+  return true;
+}
+
+void DigitLabel::invalidate_cells(size_t first, size_t last, LabelStats &stats)
+{
+  lv_area_t cells;
+  lv_obj_get_content_coords(_attached, &cells);
+  cells.x1 += lv_coord_t(first) * _cell_w - _overhang_left;
+  cells.x2 = cells.x1 + lv_coord_t(last - first + 1) * _cell_w - 1 + _overhang_left + _overhang_right;
+
+  stats.dirty_px += lv_area_get_size(&cells);
+  lv_obj_invalidate_area(_attached, &cells);
+}
+
+bool DigitLabel::set(const char *text, LabelStats &stats)
+{
+  if (*_label == nullptr)
+  {
+    return false;
+  }
+
+  auto len = std::strlen(text);
+  if (_attached != *_label || !_monospace || len != _len)
+  {
+    return attach(text, stats);
+  }
+
+  // invalidate each run of changed cells as one area
+  bool changed = false;
+  size_t run_start = 0;
+  bool in_run = false;
+  for (size_t i = 0; i <= _len; ++i)
+  {
+    bool differs = i < _len && _text[i] != text[i];
+    if (differs)
+    {
+      _text[i] = text[i];
+      if (!in_run)
+      {
+        run_start = i;
+        in_run = true;
+      }
+    }
+    else if (in_run)
+    {
+      invalidate_cells(run_start, i - 1, stats);
+      in_run = false;
+      changed = true;
+    }
+  }
+
+  if (changed)
+  {
+    stats.sets++;
+  }
+  else
+  {
+    stats.skips++;
+  }
+  return changed;
+}
+
+void DigitLabel::invalidate()
+{
+  _attached = nullptr;
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include "ui/label_stats.hpp"
+
+#include <lvgl.h>
+
+#include <array>
+
+namespace ui
+{
+  // Label in a monospaced font that is updated in place and only invalidates the glyph cells whose
+  // character changed, so a ticking second redraws one or two cells instead of the whole label box.
+  // Falls back to setting the whole text again, which invalidates the whole label, when the font
+  // turns out not to be monospaced or the length of the text changes.
+  class DigitLabel
+  {
+  public:
+    explicit DigitLabel(lv_obj_t **label);
+
+    bool set(const char *text, LabelStats &stats);
+    void invalidate();
+
+  private:
+    bool attach(const char *text, LabelStats &stats);
+    void invalidate_cells(size_t first, size_t last, LabelStats &stats);
+
+    lv_obj_t **_label;
+    lv_obj_t *_attached{nullptr};
+    // the label draws straight from this buffer (lv_label_set_text_static)
+    std::array<char, 16> _text{0};
+    size_t _len{0};
+    bool _monospace{false};
+    lv_coord_t _cell_w{0};
+    // how far glyph bitmaps reach outside of their advance width
+    lv_coord_t _overhang_left{0};
+    lv_coord_t _overhang_right{0};
+  };
+}
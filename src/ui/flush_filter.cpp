@@ -0,0 +1,138 @@
+#include "ui/flush_filter.hpp"
+
+#include <cstring>
+
+using namespace ui;
+
+static constexpr uint32_t PRIME1 = 0x9E3779B1u;
+static constexpr uint32_t PRIME2 = 0x85EBCA77u;
+static constexpr uint32_t PRIME3 = 0xC2B2AE3Du;
+static constexpr uint32_t PRIME4 = 0x27D4EB2Fu;
+static constexpr uint32_t PRIME5 = 0x165667B1u;
+
+static inline uint32_t rotl(uint32_t x, int r)
+{
+  return x << r | x >> (32 - r);
+}
+
+static inline uint32_t read32(const uint8_t *p)
+{
+  uint32_t v;
+  memcpy(&v, p, sizeof(v));
+  return v;
+}
+
+static inline uint32_t xxh_round(uint32_t acc, uint32_t input)
+{
+  return rotl(acc + input * PRIME2, 13) * PRIME1;
+}
+
+// XXH32 with seed 0. A few cycles per word where zephyr's table-less crc32 takes a step per bit, a
+// band hashes in a fraction of the time it takes to send it.
+static uint32_t xxh32(const uint8_t *data, size_t len)
+{
+  const uint8_t *end = data + len;
+  uint32_t h;
+
+  if (len >= 16)
+  {
+    uint32_t v1 = PRIME1 + PRIME2;
+    uint32_t v2 = PRIME2;
+    uint32_t v3 = 0;
+    uint32_t v4 = -PRIME1;
+    for (const uint8_t *limit = end - 16; data <= limit; data += 16)
+    {
+      v1 = xxh_round(v1, read32(data));
+      v2 = xxh_round(v2, read32(data + 4));
+      v3 = xxh_round(v3, read32(data + 8));
+      v4 = xxh_round(v4, read32(data + 12));
+    }
+    h = rotl(v1, 1) + rotl(v2, 7) + rotl(v3, 12) + rotl(v4, 18);
+  }
+  else
+  {
+    h = PRIME5;
+  }
+  h += uint32_t(len);
+
+  for (; data + 4 <= end; data += 4)
+  {
+    h = rotl(h + read32(data) * PRIME3, 17) * PRIME4;
+  }
+  for (; data < end; ++data)
+  {
+    h = rotl(h + *data * PRIME5, 11) * PRIME1;
+  }
+
+  h ^= h >> 15;
+  h *= PRIME2;
+  h ^= h >> 13;
+  h *= PRIME3;
+  h ^= h >> 16;
+  return h;
+}
+
+bool FlushFilter::check(const lv_area_t *area, uint32_t hash, bool fill)
+{
+  Entry *same = nullptr;
+  for (auto &entry : _entries)
+  {
+    if (!entry.valid)
+      continue;
+    if (lv_area_is_equal(&entry.area, area))
+    {
+      same = &entry;
+    }
+    else if (_lv_area_is_on(&entry.area, area))
+    {
+      // the new pixels overwrite part of it, its hash no longer matches the panel
+      entry.valid = false;
+    }
+  }
+
+  if (same != nullptr && same->hash == hash && same->fill == fill)
+  {
+    _stats.hits++;
+    _stats.skipped_bytes += lv_area_get_size(area) * sizeof(lv_color_t);
+    return true;
+  }
+
+  _stats.misses++;
+  if (same == nullptr)
+  {
+    same = &_entries[_next];
+    _next = (_next + 1) % _entries.size();
+  }
+  *same = {*area, hash, fill, true};
+  return false;
+}
+
+bool FlushFilter::unchanged(const lv_area_t *area, const lv_color_t *pixels)
+{
+  auto hash = xxh32((const uint8_t *)pixels, lv_area_get_size(area) * sizeof(lv_color_t));
+  return check(area, hash, false);
+}
+
+bool FlushFilter::unchanged(const lv_area_t *area, lv_color_t color)
+{
+  return check(area, lv_color_to32(color), true);
+}
+
+void FlushFilter::forget(const lv_area_t *area)
+{
+  for (auto &entry : _entries)
+  {
+    if (entry.valid && _lv_area_is_on(&entry.area, area))
+    {
+      entry.valid = false;
+    }
+  }
+}
+
+void FlushFilter::reset()
+{
+  for (auto &entry : _entries)
+  {
+    entry.valid = false;
+  }
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <lvgl.h>
+
+#include <array>
+#include <cstdint>
+
+namespace ui
+{
+  struct FlushFilterStats
+  {
+    uint32_t hits;          // flushes skipped because the panel already showed the pixels
+    uint32_t misses;        // flushes that had to be sent
+    uint64_t skipped_bytes; // pixel data that was not sent
+  };
+
+  // Remembers a hash of the last CONFIG_NRF_TEST_DISPLAY_FLUSH_FILTER_ENTRIES flushed areas, so a
+  // redraw that ends up with the same pixels, like a label set to the same text or a settled
+  // animation, doesn't have to be sent to the panel again. Every write to the panel has to go through
+  // here, or be reported with forget, for the hashes to match what the panel holds.
+  class FlushFilter
+  {
+  public:
+    // Returns true when the panel already shows these pixels at area. Otherwise they are remembered
+    // as what the panel shows after the caller sent them.
+    bool unchanged(const lv_area_t *area, const lv_color_t *pixels);
+    // Same for an area filled with one color.
+    bool unchanged(const lv_area_t *area, lv_color_t color);
+    // Drops everything overlapping area, for writes that failed or didn't go through the filter.
+    void forget(const lv_area_t *area);
+    // Drops everything, when the panel lost its contents.
+    void reset();
+
+    const FlushFilterStats &stats() const { return _stats; }
+
+  private:
+    struct Entry
+    {
+      lv_area_t area;
+      uint32_t hash;
+      bool fill;  // hash is the fill color
+      bool valid;
+    };
+
+    bool check(const lv_area_t *area, uint32_t hash, bool fill);
+
+    std::array<Entry, CONFIG_NRF_TEST_DISPLAY_FLUSH_FILTER_ENTRIES> _entries{};
+    // entries are replaced round robin, areas rarely live long enough for anything smarter to pay off
+    size_t _next{0};
+    FlushFilterStats _stats{};
+  };
+}
@@ -0,0 +1,270 @@
+#include "ui/hw_scroll.hpp"
+
+#include "drivers/display/gc9a01.hpp"
+
+#include <algorithm>
+
+using namespace ui;
+
+// coordinates along and across the scroll axis
+static inline lv_coord_t &lo(lv_area_t &area, bool on_x) { return on_x ? area.x1 : area.y1; }
+static inline lv_coord_t &hi(lv_area_t &area, bool on_x) { return on_x ? area.x2 : area.y2; }
+static inline lv_coord_t &cross_lo(lv_area_t &area, bool on_x) { return on_x ? area.y1 : area.x1; }
+static inline lv_coord_t &cross_hi(lv_area_t &area, bool on_x) { return on_x ? area.y2 : area.x2; }
+
+// the rounder and event callbacks are plain function pointers, there is only one display to hook
+static HwScroll *hooked = nullptr;
+
+void HwScroll::attach(lv_disp_t *disp, const device *display, FlushFilter *filter)
+{
+  _disp = disp;
+  _display = display;
+  _filter = filter;
+  hooked = this;
+  _next_rounder = disp->driver->rounder_cb;
+  disp->driver->rounder_cb = rounder_cb;
+}
+
+lv_area_t HwScroll::scroll_area() const
+{
+  lv_area_t area;
+  lo(area, _on_x) = _start;
+  hi(area, _on_x) = _start + _len - 1;
+  cross_lo(area, _on_x) = _cross1;
+  cross_hi(area, _on_x) = _cross2;
+  return area;
+}
+
+bool HwScroll::scrolls(const lv_area_t *area) const
+{
+  if (_obj == nullptr)
+  {
+    return false;
+  }
+  auto scroll_area = this->scroll_area();
+  return _lv_area_is_on(area, &scroll_area);
+}
+
+int HwScroll::bind(lv_obj_t *obj)
+{
+  unbind();
+
+  _on_x = gc9a01_scroll_axis(_display) == GC9A01_SCROLL_X;
+  if ((lv_obj_get_scroll_dir(obj) & (_on_x ? LV_DIR_HOR : LV_DIR_VER)) == 0)
+  {
+    return -ENOTSUP;
+  }
+
+  // the panel scrolls whole lines, nothing else may share them
+  lv_obj_update_layout(obj);
+  lv_area_t coords;
+  lv_obj_get_coords(obj, &coords);
+  lv_area_t screen = {0, 0, lv_coord_t(lv_disp_get_hor_res(_disp) - 1), lv_coord_t(lv_disp_get_ver_res(_disp) - 1)};
+  if (!_lv_area_intersect(&coords, &coords, &screen) ||
+      cross_lo(coords, _on_x) > cross_lo(screen, _on_x) ||
+      cross_hi(coords, _on_x) < cross_hi(screen, _on_x))
+  {
+    return -EINVAL;
+  }
+
+  _start = lo(coords, _on_x);
+  _len = hi(coords, _on_x) - _start + 1;
+  _cross1 = cross_lo(coords, _on_x);
+  _cross2 = cross_hi(coords, _on_x);
+  int err = gc9a01_scroll_define(_display, _start, _len);
+  if (err)
+  {
+    return err;
+  }
+
+  _obj = obj;
+  _offset = 0;
+  _moved = false;
+  _pos = _on_x ? lv_obj_get_scroll_x(obj) : lv_obj_get_scroll_y(obj);
+  lv_obj_set_scrollbar_mode(obj, LV_SCROLLBAR_MODE_OFF);
+  lv_obj_add_event_cb(obj, scroll_cb, LV_EVENT_SCROLL, this);
+  lv_obj_add_event_cb(obj, delete_cb, LV_EVENT_DELETE, this);
+
+  // the panel still holds the lines with clipped corners, redraw them in full once
+  auto area = scroll_area();
+  _filter->forget(&area);
+  _lv_inv_area(_disp, &area);
+  return 0;
+}
+
+void HwScroll::unbind()
+{
+  if (_obj == nullptr)
+    return;
+
+  lv_obj_remove_event_cb_with_user_data(_obj, scroll_cb, this);
+  lv_obj_remove_event_cb_with_user_data(_obj, delete_cb, this);
+  release();
+}
+
+void HwScroll::release()
+{
+  _obj = nullptr;
+  _moved = false;
+
+  // back to no offset, every line of the area has to be sent again where it belongs
+  gc9a01_scroll_to(_display, 0);
+  auto area = scroll_area();
+  _filter->forget(&area);
+  _lv_inv_area(_disp, &area);
+}
+
+void HwScroll::scroll_cb(lv_event_t *e)
+{
+  auto *scroll = (HwScroll *)lv_event_get_user_data(e);
+  auto pos = scroll->_on_x ? lv_obj_get_scroll_x(scroll->_obj) : lv_obj_get_scroll_y(scroll->_obj);
+  auto distance = pos - scroll->_pos;
+  scroll->_pos = pos;
+  if (distance != 0)
+  {
+    scroll->scrolled(distance);
+  }
+}
+
+void HwScroll::delete_cb(lv_event_t *e)
+{
+  // the callbacks go with the object
+  auto *scroll = (HwScroll *)lv_event_get_user_data(e);
+  scroll->release();
+}
+
+// Called before lvgl invalidates the whole object, distance > 0 moved the content towards lower
+// coordinates.
+void HwScroll::scrolled(lv_coord_t distance)
+{
+  _moved = false;
+  if (LV_ABS(distance) >= _len || !move_invalidated(distance))
+  {
+    _stats.redraws++;
+    return;
+  }
+
+  auto area = scroll_area();
+  _filter->forget(&area);
+
+  _exposed = area;
+  if (distance > 0)
+  {
+    lo(_exposed, _on_x) = _start + _len - distance;
+  }
+  else
+  {
+    hi(_exposed, _on_x) = _start - distance - 1;
+  }
+  _moved = true;
+
+  _stats.scrolls++;
+  _stats.saved_px += uint64_t(_len - LV_ABS(distance)) * (_cross2 - _cross1 + 1);
+}
+
+// Moves the scroll offset and the areas that are already invalidated in the scroll area along with the
+// content. Returns false without changing anything if an area crosses its edges.
+bool HwScroll::move_invalidated(lv_coord_t distance)
+{
+  auto area = scroll_area();
+  auto count = _disp->inv_p;
+
+  for (uint16_t i = 0; i < count; ++i)
+  {
+    if (_lv_area_is_on(&_disp->inv_areas[i], &area) && !_lv_area_is_in(&_disp->inv_areas[i], &area, 0))
+    {
+      return false;
+    }
+  }
+
+  _offset = ((_offset + distance) % _len + _len) % _len;
+  gc9a01_scroll_to(_display, _offset);
+
+  // areas that scrolled out completely are dropped
+  uint16_t kept = 0;
+  for (uint16_t i = 0; i < count; ++i)
+  {
+    auto inv = _disp->inv_areas[i];
+    if (_lv_area_is_on(&inv, &area))
+    {
+      lo(inv, _on_x) = std::max<lv_coord_t>(lo(inv, _on_x) - distance, _start);
+      hi(inv, _on_x) = std::min<lv_coord_t>(hi(inv, _on_x) - distance, _start + _len - 1);
+      if (lo(inv, _on_x) > hi(inv, _on_x))
+        continue;
+    }
+    _disp->inv_areas[kept] = inv;
+    _disp->inv_area_joined[kept] = _disp->inv_area_joined[i];
+    kept++;
+  }
+  _disp->inv_p = kept;
+
+  // and the ones that now cross the wrap are split
+  for (uint16_t i = 0; i < kept; ++i)
+  {
+    lv_area_t rest;
+    if (split(&_disp->inv_areas[i], &rest))
+    {
+      _lv_inv_area(_disp, &rest);
+    }
+  }
+  return true;
+}
+
+// Cuts area at the first edge or the wrap of the scroll area it crosses.
+bool HwScroll::split(lv_area_t *area, lv_area_t *rest)
+{
+  const lv_coord_t cuts[] = {_start, lv_coord_t(_start + _len), lv_coord_t(gc9a01_scroll_wrap(_display))};
+  lv_coord_t cut = LV_COORD_MAX;
+  for (auto c : cuts)
+  {
+    if (lo(*area, _on_x) < c && c <= hi(*area, _on_x))
+    {
+      cut = std::min(cut, c);
+    }
+  }
+  if (cut == LV_COORD_MAX)
+  {
+    return false;
+  }
+
+  *rest = *area;
+  lo(*rest, _on_x) = cut;
+  hi(*area, _on_x) = cut - 1;
+  return true;
+}
+
+void HwScroll::rounder_cb(lv_disp_drv_t *disp_drv, lv_area_t *area)
+{
+  auto *scroll = hooked;
+
+  if (scroll->_obj != nullptr)
+  {
+    auto scroll_area = scroll->scroll_area();
+    // only the object's own invalidation right after the scroll, not a redraw of the whole screen
+    lv_area_t obj_area;
+    lv_obj_get_coords(scroll->_obj, &obj_area);
+    auto ext = _lv_obj_get_ext_draw_size(scroll->_obj);
+    lv_area_increase(&obj_area, ext, ext);
+    if (scroll->_moved && _lv_area_is_in(&scroll_area, area, 0) && _lv_area_is_in(area, &obj_area, 0))
+    {
+      *area = scroll->_exposed;
+      scroll->_moved = false;
+    }
+
+    // the first piece is handed back to lvgl, the rest comes back through here
+    lv_area_t rest;
+    if (scroll->split(area, &rest))
+    {
+      _lv_inv_area(scroll->_disp, &rest);
+    }
+    if (_lv_area_is_in(area, &scroll_area, 0))
+    {
+      return;
+    }
+  }
+
+  if (scroll->_next_rounder != nullptr)
+  {
+    scroll->_next_rounder(disp_drv, area);
+  }
+}
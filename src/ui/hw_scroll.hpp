@@ -0,0 +1,70 @@
+#pragma once
+
+#include <zephyr/device.h>
+
+#include "ui/flush_filter.hpp"
+
+#include <lvgl.h>
+
+#include <cstdint>
+
+namespace ui
+{
+  struct HwScrollStats
+  {
+    uint32_t scrolls;  // scroll steps done with the panel's scroll registers
+    uint32_t redraws;  // steps too large or too tangled for it that were redrawn as usual
+    uint64_t saved_px; // pixels that moved on the panel instead of being rendered and sent
+  };
+
+  // Scrolls one object with the GC9A01 scroll registers. LVGL still moves the children, but the
+  // invalidation of the whole object is replaced by the lines that scrolled into view, and the panel
+  // is told to show the rest moved by the scroll distance. Areas in the scroll area are split at its
+  // edges and where it wraps, and are not clipped to the round panel so their corners are valid
+  // wherever they scroll to.
+  class HwScroll
+  {
+  public:
+    // Chains to the rounder already set on disp, attach after RoundMask.
+    void attach(lv_disp_t *disp, const device *display, FlushFilter *filter);
+
+    // obj has to span the whole display across the panel's scroll axis, see gc9a01_scroll_axis, scroll
+    // along it and keep its position. Its scrollbar is turned off, it would scroll along.
+    int bind(lv_obj_t *obj);
+    void unbind();
+    // True if area lies in the scroll area of the bound object, it has to be sent unclipped.
+    bool scrolls(const lv_area_t *area) const;
+
+    const HwScrollStats &stats() const { return _stats; }
+
+  private:
+    static void rounder_cb(lv_disp_drv_t *disp_drv, lv_area_t *area);
+    static void scroll_cb(lv_event_t *e);
+    static void delete_cb(lv_event_t *e);
+
+    void release();
+    void scrolled(lv_coord_t distance);
+    bool move_invalidated(lv_coord_t distance);
+    bool split(lv_area_t *area, lv_area_t *rest);
+    lv_area_t scroll_area() const;
+
+    lv_disp_t *_disp{nullptr};
+    const device *_display{nullptr};
+    FlushFilter *_filter{nullptr};
+    void (*_next_rounder)(lv_disp_drv_t *disp_drv, lv_area_t *area){nullptr};
+
+    lv_obj_t *_obj{nullptr};
+    bool _on_x{false};
+    // the scroll area along the axis and the object's extent across it
+    lv_coord_t _start{0}, _len{0};
+    lv_coord_t _cross1{0}, _cross2{0};
+    lv_coord_t _pos{0};
+    lv_coord_t _offset{0};
+
+    // the next invalidation of the whole scroll area is replaced by the lines that scrolled into view
+    bool _moved{false};
+    lv_area_t _exposed{};
+
+    HwScrollStats _stats{};
+  };
+}
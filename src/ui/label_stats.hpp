@@ -0,0 +1,13 @@
+#pragma once
+
+#include <cstdint>
+
+namespace ui
+{
+  struct LabelStats
+  {
+    uint32_t sets;     // label texts that changed and were pushed to lvgl
+    uint32_t skips;    // label texts that were identical and left alone
+    uint64_t dirty_px; // pixels invalidated by the label changes
+  };
+}
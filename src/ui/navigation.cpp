@@ -0,0 +1,172 @@
+#include "ui/navigation.hpp"
+
+#include "drivers/input/cst816s.hpp"
+#include "ui/ui.h"
+
+#include <zephyr/devicetree.h>
+#include <zephyr/input/input.h>
+
+#include <climits>
+#include <utility>
+
+using namespace ui;
+
+#define POINTER_NODE DT_NODELABEL(lvgl_pointer_input)
+
+constexpr bool SWAP_XY = DT_PROP(POINTER_NODE, swap_xy);
+constexpr bool INVERT_X = DT_PROP(POINTER_NODE, invert_x);
+constexpr bool INVERT_Y = DT_PROP(POINTER_NODE, invert_y);
+
+struct Route
+{
+  lv_obj_t **from;
+  Gesture gesture;
+  lv_obj_t **to;
+  lv_scr_load_anim_t anim;
+  void (*init)(void);
+};
+
+static const Route routes[] = {
+    {&ui_watchface, Gesture::SwipeRight, &ui_settings, LV_SCR_LOAD_ANIM_MOVE_RIGHT, ui_settings_screen_init},
+    {&ui_watchface, Gesture::SwipeLeft, &ui_stopwatch, LV_SCR_LOAD_ANIM_MOVE_LEFT, ui_stopwatch_screen_init},
+    {&ui_watchface, Gesture::LongPress, &ui_settings, LV_SCR_LOAD_ANIM_FADE_ON, ui_settings_screen_init},
+    {&ui_settings, Gesture::SwipeLeft, &ui_watchface, LV_SCR_LOAD_ANIM_MOVE_LEFT, ui_watchface_screen_init},
+    {&ui_settings, Gesture::DoubleClick, &ui_watchface, LV_SCR_LOAD_ANIM_FADE_ON, ui_watchface_screen_init},
+    {&ui_stopwatch, Gesture::SwipeRight, &ui_watchface, LV_SCR_LOAD_ANIM_MOVE_RIGHT, ui_watchface_screen_init},
+    {&ui_stopwatch, Gesture::DoubleClick, &ui_watchface, LV_SCR_LOAD_ANIM_FADE_ON, ui_watchface_screen_init},
+};
+
+constexpr int SCREEN_CHANGE_MS = 250;
+
+// the feedback callback is a plain function pointer, there is only one pointer to hook
+static Navigation *hooked = nullptr;
+
+Gesture Navigation::from_input(uint16_t code)
+{
+  // direction of the swipe in controller coordinates
+  int dx = 0;
+  int dy = 0;
+  switch (code)
+  {
+  case INPUT_BTN_NORTH:
+    dy = -1;
+    break;
+  case INPUT_BTN_SOUTH:
+    dy = 1;
+    break;
+  case INPUT_BTN_WEST:
+    dx = -1;
+    break;
+  case INPUT_BTN_EAST:
+    dx = 1;
+    break;
+  case CST816S_BTN_CLICK:
+    return Gesture::Click;
+  case CST816S_BTN_DOUBLE_CLICK:
+    return Gesture::DoubleClick;
+  case CST816S_BTN_LONG_PRESS:
+    return Gesture::LongPress;
+  default:
+    return Gesture::None;
+  }
+
+  // same order as the pointer input: swap first, then invert
+  if (SWAP_XY)
+  {
+    std::swap(dx, dy);
+  }
+  dx = INVERT_X ? -dx : dx;
+  dy = INVERT_Y ? -dy : dy;
+
+  if (dx != 0)
+  {
+    return dx < 0 ? Gesture::SwipeLeft : Gesture::SwipeRight;
+  }
+  return dy < 0 ? Gesture::SwipeUp : Gesture::SwipeDown;
+}
+
+void Navigation::attach(lv_indev_t *indev)
+{
+  hooked = this;
+  // no move within a read period on a 240 px panel is that fast, so lvgl never sends LV_EVENT_GESTURE
+  // and the handlers in ui.c can't switch a second time
+  indev->driver->gesture_min_velocity = UINT8_MAX;
+  indev->driver->feedback_cb = feedback_cb;
+}
+
+void Navigation::feedback_cb(lv_indev_drv_t *indev_drv, uint8_t event_code)
+{
+  auto *navigation = hooked;
+  if (event_code == LV_EVENT_PRESSED)
+  {
+    // only valid while lvgl processes the indev
+    navigation->_pressed = lv_indev_get_obj_act();
+    navigation->_released = false;
+    navigation->_pending = Gesture::None;
+  }
+  else if (event_code == LV_EVENT_RELEASED)
+  {
+    navigation->_released = true;
+    if (navigation->_pending != Gesture::None)
+    {
+      navigation->route(std::exchange(navigation->_pending, Gesture::None));
+    }
+  }
+}
+
+void Navigation::dispatch(Gesture gesture)
+{
+  _stats.gestures++;
+
+  // the gesture comes with the release, lvgl usually reads it on the next refresh
+  if (!_released)
+  {
+    _pending = gesture;
+    return;
+  }
+  route(gesture);
+}
+
+bool Navigation::route(Gesture gesture)
+{
+  auto *screen = lv_scr_act();
+  auto *target = _pressed;
+  if (target == nullptr || lv_obj_get_screen(target) != screen)
+  {
+    return false;
+  }
+  if (gesture == Gesture::Click || gesture == Gesture::DoubleClick || gesture == Gesture::LongPress)
+  {
+    // lvgl only presses clickable objects, anything but the screen handles the tap itself
+    if (target != screen)
+    {
+      _stats.ignored++;
+      return false;
+    }
+  }
+  else
+  {
+    // where lvgl would send the gesture event, see indev_gesture
+    while (target != nullptr && lv_obj_has_flag(target, LV_OBJ_FLAG_GESTURE_BUBBLE))
+    {
+      target = lv_obj_get_parent(target);
+    }
+    if (target != screen)
+    {
+      _stats.ignored++;
+      return false;
+    }
+  }
+
+  for (const auto &route : routes)
+  {
+    if (*route.from != screen || route.gesture != gesture)
+    {
+      continue;
+    }
+    _ui_screen_change(route.to, route.anim, SCREEN_CHANGE_MS, 0, route.init);
+    _stats.switches++;
+    return true;
+  }
+  return false;
+}
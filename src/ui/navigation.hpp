@@ -0,0 +1,61 @@
+#pragma once
+
+#include <lvgl.h>
+
+#include <cstdint>
+
+namespace ui
+{
+  // Gestures recognized by the touch controller, swipes in screen coordinates.
+  enum class Gesture : uint8_t
+  {
+    None,
+    SwipeLeft,
+    SwipeRight,
+    SwipeUp,
+    SwipeDown,
+    Click,
+    DoubleClick,
+    LongPress,
+  };
+
+  struct NavigationStats
+  {
+    uint32_t gestures; // gestures dispatched
+    uint32_t switches; // of those, switched the screen
+    uint32_t ignored;  // of those, left to the widget they started on
+  };
+
+  // Switches screens on the gestures of the touch controller as soon as the finger lifts, instead of
+  // waiting for lvgl to detect a gesture in the pointer samples. The routes follow the gesture
+  // events of ui.c, double click goes back to the watchface and a long press on it opens the settings.
+  // Like lvgl's gestures, a swipe only reaches the screen if the object it started on and its parents
+  // have LV_OBJ_FLAG_GESTURE_BUBBLE, and taps and long presses on a clickable widget are its own.
+  class Navigation
+  {
+  public:
+    // Maps a key code of the touch controller to a gesture, None for other codes. The swipes are
+    // turned like the pointer input turns the points, see the lvgl_pointer_input node.
+    static Gesture from_input(uint16_t code);
+
+    // Takes over from lvgl's gesture detection on indev.
+    void attach(lv_indev_t *indev);
+    // Routes gesture once lvgl has read the release that ended it, so the object it started on is
+    // known. Call from the display thread.
+    void dispatch(Gesture gesture);
+
+    const NavigationStats &stats() const { return _stats; }
+
+  private:
+    static void feedback_cb(lv_indev_drv_t *indev_drv, uint8_t event_code);
+    // Returns true if gesture switched the screen.
+    bool route(Gesture gesture);
+
+    // the object the last press started on, and whether lvgl has read its release yet
+    lv_obj_t *_pressed{nullptr};
+    bool _released{true};
+    // a gesture of the controller that arrived before lvgl read the release
+    Gesture _pending{Gesture::None};
+    NavigationStats _stats{};
+  };
+}
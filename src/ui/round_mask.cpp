@@ -0,0 +1,92 @@
+#include "ui/round_mask.hpp"
+
+#include <algorithm>
+#include <array>
+
+using namespace ui;
+
+constexpr lv_coord_t WIDTH = DT_PROP(DT_CHOSEN(zephyr_display), width);
+constexpr lv_coord_t HEIGHT = DT_PROP(DT_CHOSEN(zephyr_display), height);
+static_assert(WIDTH == HEIGHT, "the panel has to be round");
+
+constexpr lv_coord_t GROUP_ROWS = CONFIG_NRF_TEST_DISPLAY_ROUND_GROUP_ROWS;
+
+// first visible column of each row, the circle is symmetric so the last one is WIDTH - 1 - start.
+// A pixel is visible when its center lies inside of the circle.
+static constexpr auto row_start = []
+{
+  std::array<lv_coord_t, HEIGHT> start{};
+  for (lv_coord_t y = 0; y < HEIGHT; ++y)
+  {
+    lv_coord_t x = 0;
+    auto dy = 2 * y + 1 - HEIGHT;
+    while (x < WIDTH / 2 && (2 * x + 1 - WIDTH) * (2 * x + 1 - WIDTH) + dy * dy > WIDTH * WIDTH)
+    {
+      ++x;
+    }
+    start[y] = x;
+  }
+  return start;
+}();
+
+// First visible column of the widest of the rows y1 to y2, the one closest to the middle.
+static lv_coord_t widest_start(lv_coord_t y1, lv_coord_t y2)
+{
+  auto y = std::clamp<lv_coord_t>(HEIGHT / 2, y1, y2);
+  return row_start[std::clamp<lv_coord_t>(y, 0, HEIGHT - 1)];
+}
+
+// Clips the columns of area to the rows y1 to y2, returns false if nothing of it is visible.
+static bool clip(lv_area_t *area, lv_coord_t y1, lv_coord_t y2)
+{
+  auto start = widest_start(y1, y2);
+  area->x1 = std::max(area->x1, start);
+  area->x2 = std::min<lv_coord_t>(area->x2, WIDTH - 1 - start);
+  return area->x1 <= area->x2;
+}
+
+// the rounder is a plain function pointer, there is only one display to hook
+static RoundMask *hooked = nullptr;
+
+void RoundMask::attach(lv_disp_t *disp)
+{
+  hooked = this;
+  disp->driver->rounder_cb = rounder_cb;
+}
+
+void RoundMask::rounder_cb(lv_disp_drv_t *disp_drv, lv_area_t *area)
+{
+  auto *mask = hooked;
+  auto full = lv_area_get_size(area);
+
+  mask->_stats.areas++;
+  // lvgl can't drop an area from here, one that lies completely in a corner shrinks to a visible column
+  if (!clip(area, area->y1, area->y2))
+  {
+    area->x1 = area->x2 = widest_start(area->y1, area->y2);
+  }
+  mask->_stats.saved_px += full - lv_area_get_size(area);
+}
+
+size_t RoundMask::split(const lv_area_t *band, lv_area_t (&parts)[MAX_PARTS])
+{
+  size_t count = 0;
+  uint32_t visible_px = 0;
+  for (lv_coord_t y = band->y1; y <= band->y2; y = (y / GROUP_ROWS + 1) * GROUP_ROWS)
+  {
+    lv_area_t part = {band->x1, y, band->x2, std::min<lv_coord_t>((y / GROUP_ROWS + 1) * GROUP_ROWS - 1, band->y2)};
+    if (!clip(&part, part.y1, part.y2))
+    {
+      continue;
+    }
+    visible_px += lv_area_get_size(&part);
+    parts[count++] = part;
+  }
+
+  if (count > 1)
+  {
+    _stats.splits += count - 1;
+  }
+  _stats.saved_px += lv_area_get_size(band) - visible_px;
+  return count;
+}
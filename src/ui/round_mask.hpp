@@ -0,0 +1,45 @@
+#pragma once
+
+#include <zephyr/devicetree.h>
+
+#include <lvgl.h>
+
+#include <cstddef>
+#include <cstdint>
+
+namespace ui
+{
+  struct RoundMaskStats
+  {
+    uint32_t areas;    // invalidated areas that went through the mask
+    uint32_t splits;   // extra windows created by splitting bands into row groups
+    uint64_t saved_px; // pixels outside of the circle that were not rendered or not sent
+  };
+
+  // Clips every invalidated area to the widest visible row of the round panel it covers, so whole
+  // columns in the corners are not rendered. The rows of a band are then sent in groups of
+  // CONFIG_NRF_TEST_DISPLAY_ROUND_GROUP_ROWS, each as a window of its own clipped to its widest row,
+  // so the corners above and below it aren't sent to the panel either.
+  class RoundMask
+  {
+  public:
+    // the most groups a band can cover
+    static constexpr size_t MAX_PARTS =
+        DT_PROP(DT_CHOSEN(zephyr_display), height) / CONFIG_NRF_TEST_DISPLAY_ROUND_GROUP_ROWS + 2;
+
+    void attach(lv_disp_t *disp);
+
+    // Splits band into the visible parts of its row groups, returns how many there are. None if all
+    // of it lies in the corners.
+    size_t split(const lv_area_t *band, lv_area_t (&parts)[MAX_PARTS]);
+
+    const RoundMaskStats &stats() const { return _stats; }
+
+  private:
+    // lvgl also calls this to probe how many rows fit in the draw buffer, it must not change the rows
+    // or invalidate anything
+    static void rounder_cb(lv_disp_drv_t *disp_drv, lv_area_t *area);
+
+    RoundMaskStats _stats{};
+  };
+}
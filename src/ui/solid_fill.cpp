@@ -0,0 +1,166 @@
+#include "ui/solid_fill.hpp"
+
+#include <algorithm>
+
+using namespace ui;
+
+// the draw hooks are plain function pointers, there is only one display to hook
+static SolidFill *hooked = nullptr;
+
+void SolidFill::attach(lv_disp_t *disp)
+{
+  auto *draw_ctx = disp->driver->draw_ctx;
+
+  _base = *draw_ctx;
+  hooked = this;
+
+  draw_ctx->draw_rect = draw_rect;
+  if (_base.draw_bg != nullptr)
+    draw_ctx->draw_bg = draw_bg;
+  if (_base.draw_arc != nullptr)
+    draw_ctx->draw_arc = draw_arc;
+  if (_base.draw_img_decoded != nullptr)
+    draw_ctx->draw_img_decoded = draw_img_decoded;
+  if (_base.draw_letter != nullptr)
+    draw_ctx->draw_letter = draw_letter;
+  if (_base.draw_line != nullptr)
+    draw_ctx->draw_line = draw_line;
+  if (_base.draw_polygon != nullptr)
+    draw_ctx->draw_polygon = draw_polygon;
+  if (_base.layer_init != nullptr)
+    draw_ctx->layer_init = layer_init;
+  if (_base.layer_destroy != nullptr)
+    draw_ctx->layer_destroy = layer_destroy;
+}
+
+// Records an opaque plain rectangle that covers the whole band, anything else has to be drawn.
+bool SolidFill::record(lv_draw_ctx_t *draw_ctx, const lv_draw_rect_dsc_t *dsc, const lv_area_t *coords)
+{
+  if (_layers > 0 ||
+      dsc->bg_opa < LV_OPA_MAX ||
+      dsc->blend_mode != LV_BLEND_MODE_NORMAL ||
+      dsc->bg_grad.dir != LV_GRAD_DIR_NONE ||
+      dsc->bg_img_src != nullptr ||
+      (dsc->border_width > 0 && dsc->border_opa > LV_OPA_MIN) ||
+      (dsc->outline_width > 0 && dsc->outline_opa > LV_OPA_MIN) ||
+      (dsc->shadow_width > 0 && dsc->shadow_opa > LV_OPA_MIN) ||
+      !lv_area_is_equal(draw_ctx->clip_area, draw_ctx->buf_area) ||
+      lv_draw_mask_is_any(draw_ctx->clip_area))
+  {
+    return false;
+  }
+
+  // the rounded corners must lie outside of the band
+  lv_area_t inner = *coords;
+  auto radius = std::min<lv_coord_t>(dsc->radius, std::min(lv_area_get_width(coords), lv_area_get_height(coords)) / 2);
+  inner.x1 += radius;
+  inner.y1 += radius;
+  inner.x2 -= radius;
+  inner.y2 -= radius;
+  if (!_lv_area_is_in(draw_ctx->buf_area, &inner, 0))
+  {
+    return false;
+  }
+
+  // a later fill covering the band replaces the earlier one
+  _pending = true;
+  _pending_buf = (lv_color_t *)draw_ctx->buf;
+  _pending_area = *draw_ctx->buf_area;
+  _pending_color = dsc->bg_color;
+  return true;
+}
+
+void SolidFill::materialize()
+{
+  if (!_pending)
+    return;
+
+  _pending = false;
+  lv_color_fill(_pending_buf, _pending_color, lv_area_get_size(&_pending_area));
+  _stats.materialized++;
+}
+
+bool SolidFill::take(const lv_area_t *area, lv_color_t *color)
+{
+  if (!_pending)
+    return false;
+
+  if (!lv_area_is_equal(area, &_pending_area))
+  {
+    materialize();
+    return false;
+  }
+
+  _pending = false;
+  *color = _pending_color;
+  _stats.fills++;
+  return true;
+}
+
+void SolidFill::draw_rect(lv_draw_ctx_t *draw_ctx, const lv_draw_rect_dsc_t *dsc, const lv_area_t *coords)
+{
+  if (hooked->record(draw_ctx, dsc, coords))
+    return;
+  hooked->materialize();
+  hooked->_base.draw_rect(draw_ctx, dsc, coords);
+}
+
+void SolidFill::draw_bg(lv_draw_ctx_t *draw_ctx, const lv_draw_rect_dsc_t *dsc, const lv_area_t *coords)
+{
+  if (hooked->record(draw_ctx, dsc, coords))
+    return;
+  hooked->materialize();
+  hooked->_base.draw_bg(draw_ctx, dsc, coords);
+}
+
+void SolidFill::draw_arc(lv_draw_ctx_t *draw_ctx, const lv_draw_arc_dsc_t *dsc, const lv_point_t *center,
+                         uint16_t radius, uint16_t start_angle, uint16_t end_angle)
+{
+  hooked->materialize();
+  hooked->_base.draw_arc(draw_ctx, dsc, center, radius, start_angle, end_angle);
+}
+
+void SolidFill::draw_img_decoded(lv_draw_ctx_t *draw_ctx, const lv_draw_img_dsc_t *dsc, const lv_area_t *coords,
+                                 const uint8_t *map_p, lv_img_cf_t color_format)
+{
+  hooked->materialize();
+  hooked->_base.draw_img_decoded(draw_ctx, dsc, coords, map_p, color_format);
+}
+
+void SolidFill::draw_letter(lv_draw_ctx_t *draw_ctx, const lv_draw_label_dsc_t *dsc, const lv_point_t *pos_p,
+                            uint32_t letter)
+{
+  hooked->materialize();
+  hooked->_base.draw_letter(draw_ctx, dsc, pos_p, letter);
+}
+
+void SolidFill::draw_line(lv_draw_ctx_t *draw_ctx, const lv_draw_line_dsc_t *dsc, const lv_point_t *point1,
+                          const lv_point_t *point2)
+{
+  hooked->materialize();
+  hooked->_base.draw_line(draw_ctx, dsc, point1, point2);
+}
+
+void SolidFill::draw_polygon(lv_draw_ctx_t *draw_ctx, const lv_draw_rect_dsc_t *dsc, const lv_point_t *points,
+                             uint16_t point_cnt)
+{
+  hooked->materialize();
+  hooked->_base.draw_polygon(draw_ctx, dsc, points, point_cnt);
+}
+
+lv_draw_layer_ctx_t *SolidFill::layer_init(lv_draw_ctx_t *draw_ctx, lv_draw_layer_ctx_t *layer_ctx,
+                                           lv_draw_layer_flags_t flags)
+{
+  // layers blend onto the band and redirect the draw buffer while they are open
+  hooked->materialize();
+  auto *layer = hooked->_base.layer_init(draw_ctx, layer_ctx, flags);
+  if (layer != nullptr)
+    hooked->_layers++;
+  return layer;
+}
+
+void SolidFill::layer_destroy(lv_draw_ctx_t *draw_ctx, lv_draw_layer_ctx_t *layer_ctx)
+{
+  hooked->_base.layer_destroy(draw_ctx, layer_ctx);
+  hooked->_layers--;
+}
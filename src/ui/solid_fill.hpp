@@ -0,0 +1,60 @@
+#pragma once
+
+#include <lvgl.h>
+
+#include <cstdint>
+
+namespace ui
+{
+  struct SolidFillStats
+  {
+    uint32_t fills;        // bands sent as a solid fill
+    uint32_t materialized; // pending fills that had to be rendered after all
+  };
+
+  // Hooks the software draw context of a display so an opaque rectangle covering a whole band is not
+  // rendered into the VDB. The fill is only recorded and rendered when anything else draws into the
+  // band afterwards. A band that is still a plain fill when it is flushed can be sent with
+  // gc9a01_fill_rect instead of its pixels.
+  class SolidFill
+  {
+  public:
+    void attach(lv_disp_t *disp);
+
+    // Returns true with the color when area is a pending fill, the VDB holds garbage in that case.
+    bool take(const lv_area_t *area, lv_color_t *color);
+
+    const SolidFillStats &stats() const { return _stats; }
+
+  private:
+    static void draw_rect(lv_draw_ctx_t *draw_ctx, const lv_draw_rect_dsc_t *dsc, const lv_area_t *coords);
+    static void draw_bg(lv_draw_ctx_t *draw_ctx, const lv_draw_rect_dsc_t *dsc, const lv_area_t *coords);
+    static void draw_arc(lv_draw_ctx_t *draw_ctx, const lv_draw_arc_dsc_t *dsc, const lv_point_t *center,
+                         uint16_t radius, uint16_t start_angle, uint16_t end_angle);
+    static void draw_img_decoded(lv_draw_ctx_t *draw_ctx, const lv_draw_img_dsc_t *dsc, const lv_area_t *coords,
+                                 const uint8_t *map_p, lv_img_cf_t color_format);
+    static void draw_letter(lv_draw_ctx_t *draw_ctx, const lv_draw_label_dsc_t *dsc, const lv_point_t *pos_p,
+                            uint32_t letter);
+    static void draw_line(lv_draw_ctx_t *draw_ctx, const lv_draw_line_dsc_t *dsc, const lv_point_t *point1,
+                          const lv_point_t *point2);
+    static void draw_polygon(lv_draw_ctx_t *draw_ctx, const lv_draw_rect_dsc_t *dsc, const lv_point_t *points,
+                             uint16_t point_cnt);
+    static lv_draw_layer_ctx_t *layer_init(lv_draw_ctx_t *draw_ctx, lv_draw_layer_ctx_t *layer_ctx,
+                                           lv_draw_layer_flags_t flags);
+    static void layer_destroy(lv_draw_ctx_t *draw_ctx, lv_draw_layer_ctx_t *layer_ctx);
+
+    bool record(lv_draw_ctx_t *draw_ctx, const lv_draw_rect_dsc_t *dsc, const lv_area_t *coords);
+    void materialize();
+
+    // the software draw functions the hooks forward to
+    lv_draw_ctx_t _base{};
+    int _layers{0};
+
+    bool _pending{false};
+    lv_color_t *_pending_buf{nullptr};
+    lv_area_t _pending_area{};
+    lv_color_t _pending_color{};
+
+    SolidFillStats _stats{};
+  };
+}
@@ -0,0 +1,106 @@
+#include "ui/time_model.hpp"
+
+#include "ui/ui.h"
+
+#include <cstring>
+
+using namespace ui;
+
+CachedLabel::CachedLabel(lv_obj_t **label)
+    : _label(label)
+{
+}
+
+bool CachedLabel::set(const char *text, LabelStats &stats)
+{
+  if (*_label == nullptr)
+  {
+    return false;
+  }
+  if (std::strncmp(text, _text.data(), _text.size()) == 0)
+  {
+    stats.skips++;
+    return false;
+  }
+  std::strncpy(_text.data(), text, _text.size() - 1);
+
+  // lvgl invalidates the whole label box, the layout is only updated on the next refresh so this is
+  // the box before the change which is the same for the fixed width strings used here
+  stats.dirty_px += lv_area_get_size(&(*_label)->coords);
+  lv_label_set_text(*_label, _text.data());
+  stats.sets++;
+  return true;
+}
+
+void CachedLabel::invalidate()
+{
+  _text.fill(0);
+}
+
+TimeModel::TimeModel()
+    : _daymonth(&ui_daymonth),
+      _timehhmmss(&ui_timehhmmss),
+      _year(&ui_year),
+      _stopwatch(&ui_time)
+{
+}
+
+uint8_t TimeModel::update(std::time_t now)
+{
+  std::tm tm;
+  localtime_r(&now, &tm);
+
+  uint8_t changed = 0;
+  if (!_valid || tm.tm_sec != _last.tm_sec)
+  {
+    changed |= Second;
+  }
+  if (!_valid || tm.tm_min != _last.tm_min || tm.tm_hour != _last.tm_hour)
+  {
+    changed |= Minute;
+  }
+  if (!_valid || tm.tm_yday != _last.tm_yday || tm.tm_year != _last.tm_year)
+  {
+    changed |= Day;
+  }
+  _last = tm;
+  _valid = true;
+
+  std::array<char, 25> time_buf{0};
+  if (changed & (_seconds ? Second | Minute : Minute))
+  {
+    std::strftime(time_buf.data(), time_buf.size(), _seconds ? "%T" : "%R", &tm);
+    _timehhmmss.set(time_buf.data(), _stats);
+  }
+  if (changed & Day)
+  {
+    std::strftime(time_buf.data(), time_buf.size(), "%a %b %d", &tm);
+    _daymonth.set(time_buf.data(), _stats);
+    std::strftime(time_buf.data(), time_buf.size(), "%Y", &tm);
+    _year.set(time_buf.data(), _stats);
+  }
+  return changed;
+}
+
+void TimeModel::update_stopwatch(const char *text)
+{
+  _stopwatch.set(text, _stats);
+}
+
+void TimeModel::show_seconds(bool show)
+{
+  if (_seconds == show)
+    return;
+  _seconds = show;
+  _valid = false;
+  _timehhmmss.invalidate();
+}
+
+void TimeModel::invalidate()
+{
+  _valid = false;
+  _daymonth.invalidate();
+  _timehhmmss.invalidate();
+  _year.invalidate();
+  _stopwatch.invalidate();
+}
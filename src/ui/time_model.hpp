@@ -0,0 +1,65 @@
+#pragma once
+
+#include "ui/digit_label.hpp"
+#include "ui/label_stats.hpp"
+
+#include <zephyr/sys/util.h>
+
+#include <lvgl.h>
+
+#include <array>
+#include <cstdint>
+#include <ctime>
+
+namespace ui
+{
+  // Text of an lvgl label that only reaches lvgl when it actually changed, since every
+  // lv_label_set_text call re-lays out and invalidates the whole label.
+  class CachedLabel
+  {
+  public:
+    // takes a pointer to the ui_* global since the screens are created after this object
+    explicit CachedLabel(lv_obj_t **label);
+
+    bool set(const char *text, LabelStats &stats);
+    void invalidate();
+
+  private:
+    lv_obj_t **_label;
+    std::array<char, 32> _text{0};
+  };
+
+  // Watchface time fields, each string is only recomputed when its field rolls over.
+  class TimeModel
+  {
+  public:
+    enum Field : uint8_t
+    {
+      Second = BIT(0),
+      Minute = BIT(1),
+      Day = BIT(2),
+    };
+
+    TimeModel();
+
+    // Returns the fields that changed since the last update.
+    uint8_t update(std::time_t now);
+    void update_stopwatch(const char *text);
+    // Forces every label to be pushed again on the next update.
+    void invalidate();
+    // Without seconds the time label only changes once a minute, for the ambient watchface.
+    void show_seconds(bool show);
+
+    const LabelStats &stats() const { return _stats; }
+
+  private:
+    std::tm _last{};
+    bool _valid{false};
+    bool _seconds{true};
+    CachedLabel _daymonth;
+    DigitLabel _timehhmmss;
+    CachedLabel _year;
+    CachedLabel _stopwatch;
+    LabelStats _stats{};
+  };
+}
@@ -0,0 +1,133 @@
+#include "ui/touch_filter.hpp"
+
+#include <algorithm>
+
+using namespace ui;
+
+constexpr int32_t PREDICT_MS = CONFIG_NRF_TEST_TOUCH_PREDICT_MS;
+constexpr int32_t PREDICT_MAX_PX = CONFIG_NRF_TEST_TOUCH_PREDICT_MAX_PX;
+// the queue of the zephyr lvgl pointer input, it drops samples once that many wait for lvgl
+constexpr atomic_val_t QUEUE_SIZE = CONFIG_LV_Z_POINTER_INPUT_MSGQ_COUNT;
+
+// the read callback is a plain function pointer, there is only one pointer to hook
+static TouchFilter *hooked = nullptr;
+
+void TouchFilter::attach(lv_indev_t *indev)
+{
+  hooked = this;
+  _read = indev->driver->read_cb;
+  indev->driver->read_cb = read_cb;
+}
+
+void TouchFilter::queued()
+{
+  if (_read == nullptr)
+  {
+    return;
+  }
+  atomic_val_t n;
+  do
+  {
+    n = atomic_get(&_queued);
+    if (n >= QUEUE_SIZE)
+    {
+      atomic_inc(&_dropped);
+      return;
+    }
+  } while (!atomic_cas(&_queued, n, n + 1));
+}
+
+TouchFilterStats TouchFilter::stats() const
+{
+  auto stats = _stats;
+  stats.dropped = uint32_t(atomic_get(&_dropped));
+  return stats;
+}
+
+bool TouchFilter::take(lv_indev_drv_t *indev_drv, lv_indev_data_t *data)
+{
+  // an empty queue hands out the previous sample again, only read what is known to be there
+  if (atomic_get(&_queued) <= 0)
+  {
+    return false;
+  }
+  atomic_dec(&_queued);
+  _read(indev_drv, data);
+  _stats.samples++;
+  return true;
+}
+
+void TouchFilter::read_cb(lv_indev_drv_t *indev_drv, lv_indev_data_t *data)
+{
+  auto *filter = hooked;
+  lv_indev_data_t sample;
+
+  if (filter->_has_pending)
+  {
+    sample = filter->_pending;
+    filter->_has_pending = false;
+  }
+  else if (!filter->take(indev_drv, &sample))
+  {
+    // nothing new, the finger is where it was last reported and not ahead of it
+    *data = filter->_last;
+    data->continue_reading = false;
+    return;
+  }
+
+  // skip to the latest point, a press or release ends the run and is handed out by the next read
+  lv_indev_data_t next;
+  while (filter->take(indev_drv, &next))
+  {
+    if (next.state != sample.state)
+    {
+      filter->_pending = next;
+      filter->_has_pending = true;
+      break;
+    }
+    sample = next;
+    filter->_stats.coalesced++;
+  }
+
+  filter->_last = sample;
+  filter->predict(indev_drv, &sample);
+  // lvgl reads again right away while a press or release is pending
+  sample.continue_reading = filter->_has_pending;
+  *data = sample;
+}
+
+void TouchFilter::predict(lv_indev_drv_t *indev_drv, lv_indev_data_t *data)
+{
+  if (data->state != LV_INDEV_STATE_PRESSED)
+  {
+    _tracking = false;
+    return;
+  }
+
+  auto now = lv_tick_get();
+  if (!_tracking)
+  {
+    _tracking = true;
+    _vx = 0;
+    _vy = 0;
+  }
+  else if (now != _track_tick)
+  {
+    auto dt = int32_t(lv_tick_elaps(_track_tick));
+    // half of the new velocity, the controller's points jitter by a pixel or two
+    _vx = (_vx + (data->point.x - _track_point.x) * 256 / dt) / 2;
+    _vy = (_vy + (data->point.y - _track_point.y) * 256 / dt) / 2;
+  }
+  _track_point = data->point;
+  _track_tick = now;
+
+  auto dx = std::clamp(_vx * PREDICT_MS / 256, -PREDICT_MAX_PX, PREDICT_MAX_PX);
+  auto dy = std::clamp(_vy * PREDICT_MS / 256, -PREDICT_MAX_PX, PREDICT_MAX_PX);
+  if (dx == 0 && dy == 0)
+  {
+    return;
+  }
+  data->point.x = std::clamp<lv_coord_t>(data->point.x + dx, 0, lv_disp_get_hor_res(indev_drv->disp) - 1);
+  data->point.y = std::clamp<lv_coord_t>(data->point.y + dy, 0, lv_disp_get_ver_res(indev_drv->disp) - 1);
+  _stats.predicted++;
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <zephyr/sys/atomic.h>
+
+#include <lvgl.h>
+
+#include <cstdint>
+
+namespace ui
+{
+  struct TouchFilterStats
+  {
+    uint32_t samples;   // samples taken from the pointer input queue
+    uint32_t coalesced; // of those, replaced by a later sample of the same read
+    uint32_t dropped;   // samples the queue had no room for
+    uint32_t predicted; // points handed to lvgl ahead of the finger
+  };
+
+  // Hooks the read callback of the zephyr lvgl pointer input. Its queue is drained on every read and
+  // only the latest point is handed to lvgl, instead of one queued sample per read period. Press and
+  // release are never merged, a tap shorter than the read period still reaches lvgl as both. While
+  // dragging, the point is moved ahead along the finger's velocity by
+  // CONFIG_NRF_TEST_TOUCH_PREDICT_MS to make up for the time until the frame is on the panel.
+  class TouchFilter
+  {
+  public:
+    void attach(lv_indev_t *indev);
+
+    // Called from the input thread for every synced event of the touch controller, the pointer
+    // input queues one sample for each of them.
+    void queued();
+
+    TouchFilterStats stats() const;
+
+  private:
+    static void read_cb(lv_indev_drv_t *indev_drv, lv_indev_data_t *data);
+    // Reads the next queued sample, false if the queue is empty.
+    bool take(lv_indev_drv_t *indev_drv, lv_indev_data_t *data);
+    void predict(lv_indev_drv_t *indev_drv, lv_indev_data_t *data);
+
+    // the read callback of the pointer input the hook forwards to
+    void (*_read)(lv_indev_drv_t *indev_drv, lv_indev_data_t *data){nullptr};
+    // samples in the queue of the pointer input as far as the input callback has seen them
+    atomic_t _queued{ATOMIC_INIT(0)};
+    atomic_t _dropped{ATOMIC_INIT(0)};
+
+    lv_indev_data_t _last{};    // what lvgl got last, repeated while nothing new is queued
+    lv_indev_data_t _pending{}; // a press or release read behind the point it ends
+    bool _has_pending{false};
+
+    // velocity of the finger in 1/256 px per ms, from the unpredicted points
+    bool _tracking{false};
+    lv_point_t _track_point{};
+    uint32_t _track_tick{0};
+    int32_t _vx{0}, _vy{0};
+
+    TouchFilterStats _stats{};
+  };
+}